@@ -9,6 +9,9 @@
 #include <functional>
 #include <memory>
 #include <map>
+#include <chrono>
+#include <deque>
+#include <vector>
 #include <sstream>
 
 namespace api {
@@ -35,15 +38,74 @@ struct HTTPResponse {
 
 class SimpleHTTPServer {
 private:
+    // Requests larger than this are dropped rather than buffered forever
+    static constexpr size_t MAX_REQUEST_BYTES = 1024 * 1024;
+
+    // Idle keep-alive connections are closed after this long without a
+    // complete request, so pollers that vanish don't pin fds forever
+    static constexpr int KEEP_ALIVE_TIMEOUT_MS = 15000;
+
     int port_;
     std::atomic<bool> running_{false};
     std::thread server_thread_;
     std::mutex mutex_;
-    
+
     // Event streaming
     std::queue<std::string> events_;
     std::condition_variable event_cv_;
     std::mutex event_mutex_;
+
+    // SSE fan-out: every subscriber owns a bounded queue, so N clients
+    // each see the full stream and a stalled client drops its own oldest
+    // events instead of growing server memory or blocking emitEvent.
+    struct SSESubscriber {
+        std::mutex mutex;
+        std::condition_variable cv;
+        std::deque<std::string> queue;
+        size_t dropped = 0;
+    };
+    std::vector<std::shared_ptr<SSESubscriber>> subscribers_;
+    std::mutex subscribers_mutex_;
+    size_t max_subscriber_queue_ = 1024;
+
+    // Non-blocking event loop (epoll). One loop thread multiplexes all
+    // connections, so an SSE subscriber costs a few KB of buffer instead
+    // of a full thread. The thread-per-connection path remains as the
+    // portable fallback and is always used on non-Linux platforms.
+#ifdef __linux__
+    bool use_event_loop_ = true;
+#else
+    bool use_event_loop_ = false;
+#endif
+
+#ifdef __linux__
+    struct Connection {
+        int fd = -1;
+        std::string read_buffer;
+        std::string write_buffer;
+        std::deque<std::string> sse_queue;  // bounded, drop-oldest
+        size_t sse_dropped = 0;
+        bool is_sse = false;
+        bool close_after_write = false;
+        std::chrono::steady_clock::time_point last_activity;
+    };
+
+    int epoll_fd_ = -1;
+    int wakeup_fd_ = -1;
+    std::map<int, Connection> connections_;
+    std::vector<std::string> pending_broadcasts_;
+    std::mutex broadcast_mutex_;
+
+    void eventLoop(int server_socket);
+    void acceptConnections(int server_socket);
+    void handleReadable(Connection& conn);
+    void handleWritable(Connection& conn);
+    void refillWriteBuffer(Connection& conn);
+    void updateInterest(Connection& conn);
+    void closeConnection(int fd);
+    void distributeBroadcasts();
+    void closeIdleConnections();
+#endif
     
     // Callbacks
     std::function<void(const HTTPRequest&, HTTPResponse&)> request_handler_;
@@ -57,6 +119,7 @@ public:
     bool start();
     void stop();
     bool isRunning() const { return running_; }
+    void setUseEventLoop(bool enable) { use_event_loop_ = enable; }
     
     // Request handling
     void setRequestHandler(std::function<void(const HTTPRequest&, HTTPResponse&)> handler);
@@ -76,7 +139,8 @@ public:
 private:
     void serverLoop();
     void handleConnection(int client_socket);
-    HTTPRequest parseRequest(const std::string& request_data);
+    bool tryParseRequest(const std::string& buffer, HTTPRequest& request, size_t& consumed);
+    static bool wantsKeepAlive(const HTTPRequest& request);
     std::string buildResponse(const HTTPResponse& response);
     void sendResponse(int client_socket, const HTTPResponse& response);
     void handleSSEConnection(int client_socket);
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace vmm {
+
+enum class EventType : uint8_t {
+    ACCESS,
+    FAULT,
+    EVICT,
+    SWAP_IN,
+    SWAP_OUT,
+    COW_BREAK
+};
+
+// Compact binary event record for the hot path. No strings are built
+// when one of these is produced; formatting happens later on the
+// drainer thread, and only for events that are actually consumed.
+struct EventRecord {
+    EventType type = EventType::ACCESS;
+    bool is_write = false;
+    int32_t page = -1;
+    int32_t frame = -1;
+    uint64_t timestamp = 0;
+
+    EventRecord() = default;
+    EventRecord(EventType t, int32_t p, int32_t f, bool w, uint64_t ts)
+        : type(t), is_write(w), page(p), frame(f), timestamp(ts) {}
+};
+
+// Fixed-size multi-producer/single-consumer ring buffer. Producers are
+// whichever threads drive accesses — each address space has its own
+// lock, so two spaces can push concurrently; a short producer mutex
+// serializes the tail while the drainer thread pops lock-free. Push
+// never blocks on the consumer: when the ring is full the record is
+// dropped and a counter is bumped instead of stalling the simulation.
+class EventRingBuffer {
+private:
+    std::vector<EventRecord> buffer_;
+    size_t mask_;
+    std::atomic<size_t> head_{0};  // next slot to pop
+    std::atomic<size_t> tail_{0};  // next slot to push
+    std::atomic<size_t> dropped_{0};
+    std::mutex push_mutex_;        // serializes producers only
+
+public:
+    explicit EventRingBuffer(size_t capacity = 65536);
+
+    bool tryPush(const EventRecord& record);
+    bool tryPop(EventRecord& record);
+    size_t drain(std::vector<EventRecord>& out, size_t max_records);
+
+    size_t size() const;
+    size_t capacity() const { return buffer_.size(); }
+    size_t getDroppedCount() const { return dropped_.load(); }
+};
+
+} // namespace vmm
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace vmm {
+
+// Per-frame record: which page (of which address space) occupies the
+// frame, when it was last touched, and its dirty/referenced state.
+// ref_count > 1 means the frame backs copy-on-write mappings in several
+// address spaces; page/address_space then describe the first owner and
+// the VMM's sharer map holds the full list.
+struct FrameEntry {
+    int page = -1;
+    int address_space = -1;
+    int ref_count = 0;
+    size_t last_access = 0;
+    bool valid = false;
+    bool dirty = false;
+    bool referenced = false;
+};
+
+// Inverted page table: a contiguous frame-indexed array of FrameEntry,
+// kept coherent with the per-space page tables by the VMM. Replacement
+// policies receive it in selectVictimFrame, so "what page is in frame F
+// and when was it touched" is a single indexed load instead of a scan
+// over parallel vectors plus a page-table lookup.
+//
+// Synchronization is the caller's job and follows the VMM's existing
+// discipline: occupancy changes (assign/release/setDirty) happen under
+// mutex_, access stamps under replacement_mutex_ alongside the policy
+// bookkeeping that reads them. Scans that read occupancy and reference
+// bits together (the aging daemon) hold both locks, mutex_ first.
+class FrameTable {
+private:
+    std::vector<FrameEntry> entries_;
+
+public:
+    explicit FrameTable(size_t num_frames = 0);
+
+    void reset(size_t num_frames);
+
+    size_t size() const { return entries_.size(); }
+    const FrameEntry& entry(size_t frame) const { return entries_[frame]; }
+    bool isValid(size_t frame) const { return entries_[frame].valid; }
+
+    // Page placed into the frame: valid, clean, referenced, ref_count 1
+    void assign(int frame, int address_space, int page);
+
+    // Frame emptied (eviction or explicit deallocation)
+    void release(int frame);
+
+    // Copy-on-write sharing: another mapping added to / removed from an
+    // occupied frame. dropRef returns the remaining count and leaves
+    // the entry intact (the last owner still maps it).
+    void addRef(int frame);
+    int dropRef(int frame);
+    bool isShared(size_t frame) const { return entries_[frame].ref_count > 1; }
+
+    // Re-point the primary mapping (used when the first owner of a
+    // shared frame copies away and a sharer inherits it)
+    void setOwner(int frame, int address_space, int page);
+
+    void recordAccess(int frame, size_t access_time);
+    void setDirty(int frame, bool dirty);
+
+    // Aging-daemon scan: reference bits are set by recordAccess and
+    // consumed (cleared) by the active/inactive policy's ageTick
+    void clearReferenced(int frame);
+};
+
+} // namespace vmm
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace vmm {
+
+// Sampled access instrumentation built on the same per-page tracking
+// idea as PageTable's access_count/last_access_time, but kept out of
+// the page table so the hot path pays one atomic increment per access
+// and the heavier bookkeeping only runs 1-in-N.
+//
+// Exposes three views:
+//  - reuse-distance histogram (log2 buckets of accesses-between-reuses,
+//    measured in sampled time): the curve that predicts the fault rate
+//    for every frame count at once
+//  - working-set size over time: distinct pages per fixed window
+//  - per-page heat: total sampled touches per page
+class Instrumentation {
+private:
+    mutable std::mutex mutex_;
+    size_t sample_interval_;
+    size_t window_size_;
+    std::atomic<size_t> access_counter_{0};
+
+    // All in units of sampled accesses
+    size_t sampled_time_ = 0;
+    std::vector<size_t> last_access_;    // per page, 0 = never seen
+    std::vector<size_t> heat_;           // per page sampled touch count
+    std::vector<size_t> reuse_histogram_;  // log2 buckets
+
+    // Working-set tracking: epoch marking gives distinct-page counts
+    // per window without clearing arrays
+    std::vector<size_t> page_epoch_;
+    size_t current_epoch_ = 1;
+    size_t window_distinct_ = 0;
+    size_t window_position_ = 0;
+    std::vector<std::pair<uint64_t, size_t>> working_set_curve_;
+    static constexpr size_t MAX_CURVE_POINTS = 4096;
+
+public:
+    explicit Instrumentation(size_t total_pages, size_t sample_interval = 64,
+                             size_t window_size = 1024);
+
+    // Hot-path entry: cheap counter bump, full update only 1-in-N
+    void recordAccess(int page_number);
+
+    std::vector<size_t> getReuseDistanceHistogram() const;
+    std::vector<std::pair<uint64_t, size_t>> getWorkingSetCurve() const;
+    std::vector<std::pair<int, size_t>> getTopPages(size_t max_pages) const;
+    size_t getSampleInterval() const { return sample_interval_; }
+    size_t getSampledAccessCount() const;
+
+    void reset();
+
+private:
+    void recordSampledAccess(int page_number);
+};
+
+} // namespace vmm
@@ -11,6 +11,7 @@ struct PageEntry {
     bool valid = false;
     bool referenced = false;
     bool modified = false;
+    bool cow = false;        // copy-on-write: frame is shared, copy on first write
     int frame_number = -1;
     int access_count = 0;
     size_t last_access_time = 0;
@@ -22,23 +23,51 @@ struct PageEntry {
 
 class PageTable {
 private:
-    std::unordered_map<int, PageEntry> pages_;
+    // Dense mode: entries live in a contiguous array indexed directly by
+    // page number (total_pages_ is known at construction). Sparse mode
+    // keeps the original hash map for huge, mostly-untouched address
+    // spaces where a full array would be wasteful. Hierarchical mode
+    // (levels >= 2) stores entries in a radix tree whose interior nodes
+    // are allocated lazily, so a large sparse address space only pays
+    // for the subtrees it actually touches — the shape real multi-level
+    // page tables have.
+    struct RadixNode {
+        std::vector<std::unique_ptr<RadixNode>> children;  // interior nodes
+        std::vector<PageEntry> entries;                    // leaf nodes
+    };
+
+    std::vector<PageEntry> dense_pages_;
+    std::unordered_map<int, PageEntry> sparse_pages_;
+    std::unique_ptr<RadixNode> radix_root_;
+    bool dense_ = true;
+    size_t levels_ = 1;              // 1 = flat; 2-4 = radix tree
+    size_t bits_per_level_ = 0;
+    size_t radix_fanout_ = 0;
     mutable std::mutex mutex_;
     size_t page_size_;
     size_t total_pages_;
+    PageEntry scratch_entry_;        // touchEntry target for negative pages
+
+    const PageEntry* findEntry(int page_number) const;
+    PageEntry& touchEntry(int page_number);
+    void collectValidPages(const RadixNode& node, int base, size_t level,
+                           std::vector<int>& out) const;
 
 public:
-    explicit PageTable(size_t page_size = 4096, size_t total_pages = 1024);
+    explicit PageTable(size_t page_size = 4096, size_t total_pages = 1024,
+                       bool dense_storage = true, size_t levels = 1);
     
     // Page table operations
     bool isPageValid(int page_number) const;
     bool isPageReferenced(int page_number) const;
     bool isPageModified(int page_number) const;
+    bool isPageCOW(int page_number) const;
     int getFrameNumber(int page_number) const;
-    
+
     void setPageValid(int page_number, bool valid);
     void setPageReferenced(int page_number, bool referenced);
     void setPageModified(int page_number, bool modified);
+    void setPageCOW(int page_number, bool cow);
     void setFrameNumber(int page_number, int frame_number);
     
     // Access tracking
@@ -49,6 +78,7 @@ public:
     // Utility functions
     size_t getPageSize() const { return page_size_; }
     size_t getTotalPages() const { return total_pages_; }
+    size_t getLevels() const { return levels_; }
     size_t getValidPageCount() const;
     
     // Get all valid pages (for AI predictions)
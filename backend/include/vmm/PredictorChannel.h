@@ -0,0 +1,77 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace vmm {
+
+// Zero-copy channel to an out-of-process predictor sidecar: one shared
+// memory segment holding two single-producer/single-consumer rings of
+// fixed-size int32 records.
+//
+//   access ring:      VMM -> predictor, the page-access history stream
+//   prediction ring:  predictor -> VMM, page numbers to prefetch
+//
+// The hot-path write is one slot store plus one release-store of the
+// head index — no syscalls, no serialization, no locks. When the
+// sidecar falls behind, access records are dropped (and counted)
+// rather than ever stalling the simulation; prediction history is
+// lossy by nature.
+//
+// Segment layout (see ChannelHeader): a versioned header with both
+// ring's head/tail counters, followed by the two slot arrays. The
+// Python sidecar maps the same segment and mirrors this struct.
+//
+// POSIX only (shm_open/mmap); on Windows the channel reports closed
+// and the VMM falls back to the built-in heuristic predictor.
+class PredictorChannel {
+public:
+    static constexpr uint32_t MAGIC = 0x50434D56;  // "VMCP" little-endian
+    static constexpr uint32_t VERSION = 1;
+
+    struct ChannelHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t ring_capacity;        // slots per ring, power of two
+        uint32_t reserved;
+        std::atomic<uint64_t> access_head;      // written by the VMM
+        std::atomic<uint64_t> access_tail;      // written by the sidecar
+        std::atomic<uint64_t> prediction_head;  // written by the sidecar
+        std::atomic<uint64_t> prediction_tail;  // written by the VMM
+    };
+
+    // Creates (or re-creates) the segment under /dev/shm with the given
+    // name; the VMM side always owns creation and unlinks on teardown
+    PredictorChannel(const std::string& name, size_t ring_capacity);
+    ~PredictorChannel();
+
+    PredictorChannel(const PredictorChannel&) = delete;
+    PredictorChannel& operator=(const PredictorChannel&) = delete;
+
+    bool isOpen() const { return header_ != nullptr; }
+
+    // Hot path: non-blocking, drops the record when the ring is full
+    void pushAccess(int page_number);
+
+    // Drains up to max_records pending predictions from the sidecar
+    size_t pollPredictions(std::vector<int>& out, size_t max_records);
+
+    size_t getDroppedAccessCount() const { return dropped_accesses_.load(std::memory_order_relaxed); }
+
+private:
+    std::string name_;
+    size_t ring_capacity_ = 0;
+
+    ChannelHeader* header_ = nullptr;
+    int32_t* access_slots_ = nullptr;
+    int32_t* prediction_slots_ = nullptr;
+    void* mapping_ = nullptr;
+    size_t mapping_size_ = 0;
+
+    std::atomic<size_t> dropped_accesses_{0};
+};
+
+} // namespace vmm
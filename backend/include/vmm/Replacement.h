@@ -2,83 +2,242 @@
 
 #include <vector>
 #include <queue>
+#include <list>
 #include <unordered_set>
 #include <memory>
-#include "PageTable.h"
+#include <string>
+#include "FrameTable.h"
 
 namespace vmm {
 
 enum class ReplacementPolicy {
     FIFO,
     LRU,
-    CLOCK
+    LRU_FAST,
+    CLOCK,
+    OPT,
+    TWO_Q,
+    ACTIVE_INACTIVE
 };
 
 class ReplacementAlgorithm {
 public:
     virtual ~ReplacementAlgorithm() = default;
-    virtual int selectVictimFrame(const std::vector<bool>& frame_validity, 
-                                 const PageTable& page_table) = 0;
+    // Victim selection reads the inverted page table: occupancy, the
+    // resident page, last-access time and dirty state are all O(1)
+    // frame-indexed loads
+    virtual int selectVictimFrame(const FrameTable& frames) = 0;
     virtual void recordFrameAccess(int frame_number) = 0;
     virtual void recordFrameEviction(int frame_number) = 0;
     virtual std::string getPolicyName() const = 0;
+
+    // Optional page-aware hooks. Most policies only need frame numbers;
+    // OPT needs the access stream position and the frame->page mapping,
+    // and trace-aware policies get the future stream via setFutureTrace.
+    virtual void recordPageAccess(int /*page_number*/) {}
+    virtual void recordPagePlacement(int /*frame_number*/, int /*page_number*/) {}
+    virtual void setFutureTrace(const std::vector<int>& /*future_pages*/) {}
 };
 
-class FIFOReplacement : public ReplacementAlgorithm {
+// The concrete policies are final so that calls made through a concrete
+// pointer (see ReplacementManager::recordFrameAccess) devirtualize; the
+// virtual interface stays for policies selected only at runtime.
+class FIFOReplacement final : public ReplacementAlgorithm {
 private:
     std::queue<int> fifo_queue_;
     std::unordered_set<int> in_queue_;
 
 public:
-    int selectVictimFrame(const std::vector<bool>& frame_validity, 
-                         const PageTable& page_table) override;
+    int selectVictimFrame(const FrameTable& frames) override;
     void recordFrameAccess(int frame_number) override;
     void recordFrameEviction(int frame_number) override;
     std::string getPolicyName() const override { return "FIFO"; }
 };
 
-class LRUReplacement : public ReplacementAlgorithm {
+// Scan-based LRU working straight off FrameTable::last_access (stamped
+// by the VMM on every access), so it keeps no state of its own. Kept
+// for benchmark comparison against LRUFastReplacement.
+class LRUReplacement final : public ReplacementAlgorithm {
+public:
+    int selectVictimFrame(const FrameTable& frames) override;
+    void recordFrameAccess(int /*frame_number*/) override {}
+    void recordFrameEviction(int /*frame_number*/) override {}
+    std::string getPolicyName() const override { return "LRU"; }
+};
+
+// O(1) LRU: an intrusive doubly-linked list threaded through a
+// frame-indexed node array. recordFrameAccess unlinks the frame and
+// relinks it at the MRU end; selectVictimFrame pops the LRU end. No
+// allocation or scanning, unlike the time-stamp scan in LRUReplacement
+// (kept for benchmark comparison).
+class LRUFastReplacement final : public ReplacementAlgorithm {
 private:
-    std::vector<size_t> last_access_times_;
-    size_t current_time_ = 0;
+    std::vector<int> prev_;
+    std::vector<int> next_;
+    std::vector<bool> linked_;
+    int head_ = -1;  // LRU end
+    int tail_ = -1;  // MRU end
+
+    void unlink(int frame_number);
+    void linkAtTail(int frame_number);
 
 public:
-    explicit LRUReplacement(size_t num_frames);
-    int selectVictimFrame(const std::vector<bool>& frame_validity, 
-                         const PageTable& page_table) override;
+    explicit LRUFastReplacement(size_t num_frames);
+    int selectVictimFrame(const FrameTable& frames) override;
     void recordFrameAccess(int frame_number) override;
     void recordFrameEviction(int frame_number) override;
-    std::string getPolicyName() const override { return "LRU"; }
+    std::string getPolicyName() const override { return "LRU_FAST"; }
 };
 
-class CLOCKReplacement : public ReplacementAlgorithm {
+class CLOCKReplacement final : public ReplacementAlgorithm {
 private:
     std::vector<bool> reference_bits_;
     int clock_hand_ = 0;
 
 public:
     explicit CLOCKReplacement(size_t num_frames);
-    int selectVictimFrame(const std::vector<bool>& frame_validity, 
-                         const PageTable& page_table) override;
-    void recordFrameAccess(int frame_number) override;
+    int selectVictimFrame(const FrameTable& frames) override;
+    // Defined inline: this is the per-access hot path and inlines down
+    // to a single bit set when called through a concrete pointer
+    void recordFrameAccess(int frame_number) override {
+        if (frame_number >= 0 && frame_number < static_cast<int>(reference_bits_.size())) {
+            reference_bits_[frame_number] = true;
+        }
+    }
     void recordFrameEviction(int frame_number) override;
     std::string getPolicyName() const override { return "CLOCK"; }
 };
 
+// Belady's optimal policy: evicts the resident page whose next use is
+// farthest in the future. Only usable when the access stream is known
+// ahead of time (trace replay / benchmark mode); setFutureTrace builds
+// a per-page index of use positions once, so victim selection never
+// scans the trace. Serves as the fault-rate lower bound other policies
+// are measured against.
+class OPTReplacement final : public ReplacementAlgorithm {
+private:
+    std::vector<std::vector<size_t>> next_uses_;  // per page, ascending use positions
+    std::vector<size_t> next_use_cursor_;         // per page index into next_uses_
+    size_t position_ = 0;  // accesses consumed so far
+
+public:
+    int selectVictimFrame(const FrameTable& frames) override;
+    void recordFrameAccess(int frame_number) override;
+    void recordFrameEviction(int /*frame_number*/) override {}
+    void recordPageAccess(int page_number) override;
+    void setFutureTrace(const std::vector<int>& future_pages) override;
+    std::string getPolicyName() const override { return "OPT"; }
+};
+
+// 2Q adaptive policy: frames seen once sit in a FIFO probation queue
+// (A1in); a re-access promotes them to the protected LRU list (Am).
+// Victims come from the probation queue first, so one-shot scans cannot
+// flush the hot set the way plain LRU lets them.
+class TwoQReplacement final : public ReplacementAlgorithm {
+private:
+    enum class Location : char { NONE, A1IN, AM };
+    std::list<int> a1in_;  // FIFO: front = oldest
+    std::list<int> am_;    // LRU: front = least recently used
+    std::vector<std::list<int>::iterator> position_;
+    std::vector<Location> location_;
+
+    void remove(int frame_number);
+
+public:
+    explicit TwoQReplacement(size_t num_frames);
+    int selectVictimFrame(const FrameTable& frames) override;
+    void recordFrameAccess(int frame_number) override;
+    void recordFrameEviction(int frame_number) override;
+    std::string getPolicyName() const override { return "2Q"; }
+};
+
+// Linux-style two-list design: resident frames sit on an active or an
+// inactive list. The access path does nothing but link newly placed
+// frames onto the inactive list — recency is tracked through the
+// reference bits the VMM already stamps into the FrameTable. A
+// background aging daemon (VMM::agingLoop) calls ageTick to do the
+// actual work in bounded increments: demote unreferenced frames from
+// the active tail, second-chance referenced ones, and promote inactive
+// frames that got touched. selectVictimFrame then just pops the
+// inactive tail — O(1) even under pressure, when CLOCK would be cycling
+// through masses of referenced hot frames.
+class ActiveInactiveReplacement final : public ReplacementAlgorithm {
+private:
+    enum class ListId : char { NONE, ACTIVE, INACTIVE };
+    std::list<int> active_;    // head = most recently promoted
+    std::list<int> inactive_;  // tail = coldest, next victims
+    std::vector<std::list<int>::iterator> position_;
+    std::vector<ListId> location_;
+
+    void remove(int frame_number);
+
+public:
+    explicit ActiveInactiveReplacement(size_t num_frames);
+    int selectVictimFrame(const FrameTable& frames) override;
+    // Defined inline: on the per-access hot path this is a single
+    // vector load and branch (frames already on a list stay put; the
+    // daemon moves them based on reference bits)
+    void recordFrameAccess(int frame_number) override {
+        if (frame_number >= 0 && frame_number < static_cast<int>(location_.size()) &&
+            location_[frame_number] == ListId::NONE) {
+            inactive_.push_front(frame_number);
+            position_[frame_number] = inactive_.begin();
+            location_[frame_number] = ListId::INACTIVE;
+        }
+    }
+    void recordFrameEviction(int frame_number) override;
+    void ageTick(FrameTable& frames, size_t budget);
+    std::string getPolicyName() const override { return "ACTIVE_INACTIVE"; }
+};
+
 class ReplacementManager {
 private:
     std::unique_ptr<ReplacementAlgorithm> algorithm_;
+    ReplacementPolicy policy_ = ReplacementPolicy::CLOCK;
     size_t num_frames_;
 
 public:
     explicit ReplacementManager(ReplacementPolicy policy, size_t num_frames);
-    
-    int selectVictimFrame(const std::vector<bool>& frame_validity, 
-                         const PageTable& page_table);
-    void recordFrameAccess(int frame_number);
+
+    int selectVictimFrame(const FrameTable& frames);
+
+    // Hot path: recordFrameAccess runs on every access, so rather than a
+    // virtual call it switches on the policy chosen at startup and calls
+    // the concrete (final) type directly. For CLOCK the whole thing
+    // inlines to a single bit set; the default arm keeps the virtual
+    // interface working for any policy not listed here.
+    void recordFrameAccess(int frame_number) {
+        switch (policy_) {
+            case ReplacementPolicy::CLOCK:
+                static_cast<CLOCKReplacement*>(algorithm_.get())->recordFrameAccess(frame_number);
+                return;
+            case ReplacementPolicy::LRU:
+                return;  // LRU reads FrameTable::last_access directly
+            case ReplacementPolicy::LRU_FAST:
+                static_cast<LRUFastReplacement*>(algorithm_.get())->recordFrameAccess(frame_number);
+                return;
+            case ReplacementPolicy::TWO_Q:
+                static_cast<TwoQReplacement*>(algorithm_.get())->recordFrameAccess(frame_number);
+                return;
+            case ReplacementPolicy::ACTIVE_INACTIVE:
+                static_cast<ActiveInactiveReplacement*>(algorithm_.get())->recordFrameAccess(frame_number);
+                return;
+            default:
+                algorithm_->recordFrameAccess(frame_number);
+                return;
+        }
+    }
+
     void recordFrameEviction(int frame_number);
+    void recordPageAccess(int page_number);
+    void recordPagePlacement(int frame_number, int page_number);
+    void setFutureTrace(const std::vector<int>& future_pages);
+
+    // Aging-daemon entry point: a no-op for every policy except
+    // ACTIVE_INACTIVE (see VMM::agingLoop)
+    void ageTick(FrameTable& frames, size_t budget);
     std::string getPolicyName() const;
-    
+
     void setPolicy(ReplacementPolicy policy);
 };
 
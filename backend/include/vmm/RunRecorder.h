@@ -0,0 +1,94 @@
+#pragma once
+
+#include "VMM.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace vmm {
+
+// Streams periodic metric samples from a running VMM into a compact
+// columnar binary file, so long benchmark runs leave a durable artifact
+// without scraping /metrics over HTTP.
+//
+// File layout ("VMRC" format, version 1):
+//
+//   header:  magic u32 | version u32 | column_count u32 | interval_ms u32
+//   blocks:  row_count u32, then column_count arrays of row_count u64
+//            values each (column-major within the block)
+//   footer:  block_count u32 | {offset u64, rows u32} per block |
+//            {name_len u32, name bytes} per column |
+//            footer_offset u64 | magic u32
+//
+// A reader seeks to the last 12 bytes for the footer offset, reads the
+// block index and column names, and can then pull a single column out
+// of every block without touching the rest of the file.
+//
+// Sampling runs on its own thread and only reads the VMM's atomic
+// counters, so the simulation is never perturbed. Filled blocks are
+// handed to a second thread through a double buffer: the sampler swaps
+// in the spare buffer (a pointer swap under a short lock) and the
+// writer does the file I/O, so sampling never blocks on the disk.
+class RunRecorder {
+public:
+    static constexpr uint32_t MAGIC = 0x43524D56;  // "VMRC" little-endian
+    static constexpr uint32_t VERSION = 1;
+    static constexpr size_t BLOCK_ROWS = 1024;
+
+    RunRecorder(const VMM& vmm, const std::string& path, size_t interval_ms);
+    ~RunRecorder();
+
+    void start();
+    void stop();  // takes a final sample, flushes, writes the footer
+
+    bool isOpen() const { return file_.is_open(); }
+    size_t getSampleCount() const { return samples_taken_.load(std::memory_order_relaxed); }
+
+    static const std::vector<std::string>& columnNames();
+
+private:
+    // One block of samples, column-major: columns[c][r]
+    struct Block {
+        std::vector<std::vector<uint64_t>> columns;
+        size_t rows = 0;
+
+        explicit Block(size_t column_count);
+        void clear();
+    };
+
+    const VMM& vmm_;
+    size_t interval_ms_;
+    std::ofstream file_;
+
+    Block active_;
+    Block flushing_;
+    bool flush_pending_ = false;
+    std::mutex swap_mutex_;
+    std::condition_variable flush_cv_;
+
+    std::thread sampler_thread_;
+    std::thread writer_thread_;
+    std::atomic<bool> running_{false};
+    std::atomic<size_t> samples_taken_{0};
+
+    // Index footer entries, owned by the writer thread until stop()
+    struct BlockIndexEntry {
+        uint64_t offset;
+        uint32_t rows;
+    };
+    std::vector<BlockIndexEntry> block_index_;
+
+    void sample();
+    void samplerLoop();
+    void writerLoop();
+    void writeHeader();
+    void writeBlock(const Block& block);
+    void writeFooter();
+};
+
+} // namespace vmm
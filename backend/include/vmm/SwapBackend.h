@@ -0,0 +1,94 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <cstddef>
+#include <cstdint>
+
+namespace vmm {
+
+// Device profiles for the simulated swap backend. Each profile carries
+// a fixed per-operation latency plus a bandwidth term, so the cost of
+// one page transfer is latency + page_size / bandwidth.
+enum class SwapDeviceProfile {
+    NVME,
+    SSD,
+    HDD
+};
+
+struct SwapDeviceModel {
+    double read_latency_us = 80.0;
+    double write_latency_us = 90.0;
+    double bandwidth_mb_per_s = 500.0;
+
+    static SwapDeviceModel forProfile(SwapDeviceProfile profile);
+};
+
+// Plain-value snapshot of swap metrics, mirroring VMMMetricsSnapshot
+struct SwapMetricsSnapshot {
+    size_t reads = 0;
+    size_t writes = 0;
+    size_t queue_depth = 0;
+    size_t max_queue_depth = 0;
+    size_t write_stalls = 0;
+    double simulated_read_ms = 0.0;
+    double simulated_write_ms = 0.0;
+    double simulated_total_ms = 0.0;
+};
+
+// Simulated swap device. Swap-ins are synchronous and charge the read
+// cost to the simulated clock (the faulting access pays it, as on real
+// hardware). Dirty evictions go through a bounded asynchronous
+// write-back queue serviced by a background thread at the device's
+// modeled rate, so they do not stall the faulting access; when the
+// queue is full the caller pays the write cost synchronously and a
+// stall is counted. Queue-depth metrics expose how far behind the
+// device is running.
+class SwapBackend {
+private:
+    SwapDeviceModel model_;
+    size_t page_size_;
+    size_t queue_capacity_;
+
+    std::deque<int> write_queue_;  // page numbers awaiting write-back
+    mutable std::mutex queue_mutex_;
+    std::condition_variable queue_cv_;
+    std::thread writer_thread_;
+    std::atomic<bool> writer_running_{false};
+
+    std::atomic<size_t> reads_{0};
+    std::atomic<size_t> writes_{0};
+    std::atomic<size_t> max_queue_depth_{0};
+    std::atomic<size_t> write_stalls_{0};
+
+    // Simulated time in nanoseconds so atomic addition stays integral
+    std::atomic<uint64_t> simulated_read_ns_{0};
+    std::atomic<uint64_t> simulated_write_ns_{0};
+
+    double transferCostUs(double fixed_latency_us) const;
+    void writerLoop();
+
+public:
+    SwapBackend(SwapDeviceProfile profile, size_t page_size, size_t queue_capacity);
+    ~SwapBackend();
+
+    // Synchronous read of one page; charges the read cost
+    void swapIn(int page_number);
+
+    // Queue one dirty page for asynchronous write-back; falls back to a
+    // synchronous (stalling) write when the queue is full
+    void swapOut(int page_number);
+
+    // Block until the write-back queue is empty (shutdown / end of run)
+    void drain();
+
+    SwapMetricsSnapshot getMetricsSnapshot() const;
+
+    static const char* profileName(SwapDeviceProfile profile);
+};
+
+} // namespace vmm
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <cstddef>
+
+namespace vmm {
+
+// Simulated set-associative TLB consulted before the page table. A hit
+// returns the cached translation without touching PageTable (and its
+// lock), which both models real translation behavior and short-circuits
+// most lookups on locality-heavy workloads. Replacement within a set is
+// LRU via a per-entry tick counter.
+class TLB {
+private:
+    struct TLBEntry {
+        int page = -1;
+        int frame = -1;
+        bool valid = false;
+        size_t last_used = 0;
+    };
+
+    std::vector<TLBEntry> entries_;  // sets_ * ways_, set-major
+    size_t sets_;
+    size_t ways_;
+    size_t tick_ = 0;
+
+    std::atomic<size_t> hits_{0};
+    std::atomic<size_t> misses_{0};
+
+    // Internally synchronized: evictions invalidate entries in another
+    // address space's TLB while its owner may be translating
+    mutable std::mutex mutex_;
+
+    size_t setIndex(int page_number) const { return static_cast<size_t>(page_number) & (sets_ - 1); }
+
+public:
+    // total_entries is rounded so sets_ is a power of two
+    explicit TLB(size_t total_entries = 64, size_t ways = 4);
+
+    // Returns true and fills frame_number on a hit; counts the miss otherwise
+    bool lookup(int page_number, int& frame_number);
+    void insert(int page_number, int frame_number);
+    void invalidate(int page_number);
+    void flush();
+
+    size_t getHits() const { return hits_.load(std::memory_order_relaxed); }
+    size_t getMisses() const { return misses_.load(std::memory_order_relaxed); }
+    size_t getSets() const { return sets_; }
+    size_t getWays() const { return ways_; }
+};
+
+} // namespace vmm
@@ -1,14 +1,24 @@
 #pragma once
 
 #include "PageTable.h"
+#include "FrameTable.h"
 #include "Replacement.h"
+#include "EventBuffer.h"
+#include "Instrumentation.h"
+#include "TLB.h"
+#include "SwapBackend.h"
+#include "PredictorChannel.h"
 #include <vector>
 #include <memory>
 #include <atomic>
 #include <mutex>
+#include <shared_mutex>
 #include <functional>
 #include <string>
 #include <chrono>
+#include <thread>
+#include <unordered_map>
+#include <utility>
 
 namespace vmm {
 
@@ -16,9 +26,25 @@ struct VMMConfig {
     size_t total_frames = 256;
     size_t page_size = 4096;
     size_t total_pages = 1024;
+    size_t num_address_spaces = 1;   // simulated processes sharing the frame pool
+    size_t frame_pool_shards = 4;    // independent free lists in the frame allocator
+    size_t numa_nodes = 1;           // shard groups with node-local allocation + stealing
+    size_t page_table_levels = 1;    // 1 = flat table; 2-4 = hierarchical radix tree
+    size_t tlb_entries = 64;         // 0 disables the TLB layer
+    size_t tlb_associativity = 4;
+    SwapDeviceProfile swap_device = SwapDeviceProfile::SSD;
+    size_t swap_write_queue_capacity = 256;
+    size_t fault_cluster_size = 0;   // >1 enables the stride-clustering prefetcher
     ReplacementPolicy replacement_policy = ReplacementPolicy::CLOCK;
+    size_t aging_scan_budget = 64;   // frames examined per aging-daemon tick (active/inactive policy)
     bool enable_ai_predictions = false;
     std::string ai_predictor_url = "http://localhost:5000/predict";
+    std::string ai_predictor_shm;    // e.g. "/vmm_predictor"; empty = in-process heuristic
+    size_t event_ring_capacity = 65536;
+    size_t access_event_sample_interval = 1;  // emit 1-in-N ACCESS events
+    size_t instrumentation_sample_interval = 64;  // 0 disables instrumentation
+    bool logical_timestamps = false;  // stamp events with access counts, not wall time
+    std::string access_log_file;      // record the access stream in binary trace format
 };
 
 struct VMMMetrics {
@@ -28,7 +54,11 @@ struct VMMMetrics {
     std::atomic<size_t> swap_outs{0};
     std::atomic<size_t> ai_predictions{0};
     std::atomic<size_t> ai_hits{0};
-    
+    std::atomic<size_t> tlb_hits{0};
+    std::atomic<size_t> tlb_misses{0};
+    std::atomic<size_t> cluster_prefetches{0};
+    std::atomic<size_t> cow_breaks{0};
+
     // Delete copy constructor and assignment operator
     VMMMetrics() = default;
     VMMMetrics(const VMMMetrics&) = delete;
@@ -43,6 +73,40 @@ struct VMMMetrics {
     }
 };
 
+// Plain-value snapshot of all metrics, readable without touching the
+// simulation locks. Built entirely from atomic counters so a monitoring
+// poller never perturbs the access path.
+struct VMMMetricsSnapshot {
+    size_t total_accesses = 0;
+    size_t page_faults = 0;
+    size_t swap_ins = 0;
+    size_t swap_outs = 0;
+    size_t ai_predictions = 0;
+    size_t ai_hits = 0;
+    size_t tlb_hits = 0;
+    size_t tlb_misses = 0;
+    size_t cluster_prefetches = 0;
+    size_t numa_local_allocations = 0;
+    size_t numa_remote_allocations = 0;
+    size_t cow_breaks = 0;
+    size_t cow_shared_mappings = 0;
+    double dedup_ratio = 1.0;   // (used frames + shared mappings) / used frames
+    double page_fault_rate = 0.0;
+    double ai_hit_rate = 0.0;
+    double tlb_hit_rate = 0.0;
+    double ai_prediction_confidence = 0.0;
+    size_t free_frames = 0;
+    size_t used_frames = 0;
+};
+
+struct PageAccess {
+    int page_number = 0;
+    bool is_write = false;
+
+    PageAccess() = default;
+    PageAccess(int page, bool write) : page_number(page), is_write(write) {}
+};
+
 struct VMMEvent {
     std::string type;
     std::string message;
@@ -52,39 +116,156 @@ struct VMMEvent {
     VMMEvent(const std::string& t, const std::string& msg, const std::string& d = "")
         : type(t), message(msg), timestamp(std::chrono::duration_cast<std::chrono::milliseconds>(
             std::chrono::system_clock::now().time_since_epoch()).count()), data(d) {}
+
+    // Explicit timestamp (logical-clock mode: two identical runs emit
+    // identical events, so event logs can be diffed between builds)
+    VMMEvent(const std::string& t, const std::string& msg, size_t ts, const std::string& d)
+        : type(t), message(msg), timestamp(ts), data(d) {}
 };
 
 class VMM {
 private:
     VMMConfig config_;
-    std::unique_ptr<PageTable> page_table_;
+
+    // One page table (and one lock) per simulated address space. Space 0
+    // is the default and serves the single-process API unchanged.
+    std::vector<std::unique_ptr<PageTable>> page_tables_;
+    std::vector<std::unique_ptr<std::mutex>> space_mutexes_;
+
+    // One simulated TLB per address space, consulted before the page
+    // table (null when disabled via config)
+    std::vector<std::unique_ptr<TLB>> tlbs_;
+
+    // Per-space fault-stride tracking for the clustering prefetcher.
+    // Only touched in handlePageFault under the space lock.
+    struct FaultPattern {
+        int last_page = -1;
+        int last_stride = 0;
+        int unit_stride = 0;  // underlying access stride, survives clustering
+    };
+    std::vector<FaultPattern> fault_patterns_;
+
     std::unique_ptr<ReplacementManager> replacement_manager_;
     VMMMetrics metrics_;
+
+    // Frame management (shared across address spaces): the inverted
+    // page table maps each frame to its occupying page, space, dirty
+    // state and last-access time. Occupancy changes happen under
+    // mutex_; access stamps under replacement_mutex_ (policies read
+    // them in selectVictimFrame under the same lock).
+    FrameTable frame_table_;
+
+    // Sharded free-frame allocator: each shard has its own free list and
+    // lock so faults in different address spaces rarely contend.
+    struct FrameShard {
+        std::mutex mutex;
+        std::vector<int> free_frames;
+    };
+    std::vector<std::unique_ptr<FrameShard>> frame_shards_;
+    size_t frames_per_shard_ = 0;
+
+    // NUMA partitioning: shards are grouped into contiguous per-node
+    // segments. allocateFrame tries the caller's node first and only
+    // steals from other nodes when the local segment is exhausted, so
+    // frames (and the cache lines of their metadata) stay node-local
+    // under multi-threaded drivers. Counters track how often stealing
+    // was needed.
+    size_t shards_per_node_ = 0;
+    size_t num_numa_nodes_ = 1;
+    std::atomic<size_t> numa_local_allocations_{0};
+    std::atomic<size_t> numa_remote_allocations_{0};
+
+    // Maintained incrementally so metrics reads never scan the frame
+    // arrays or take the frame lock
+    std::atomic<size_t> free_frame_count_{0};
+
+    // Copy-on-write sharing: reverse map from a shared frame to every
+    // (address_space, page) mapping it backs, including the primary one
+    // recorded in the FrameEntry. Only frames with ref_count > 1 have
+    // an entry; maintained under mutex_ so eviction can unmap all
+    // sharers. cow_shared_mappings_ counts the extra mappings (each one
+    // a frame the tenants would otherwise need), kept atomic so the
+    // dedup ratio is readable without the lock.
+    std::unordered_map<int, std::vector<std::pair<int, int>>> frame_sharers_;
+    std::atomic<size_t> cow_shared_mappings_{0};
     
-    // Frame management
-    std::vector<bool> frame_validity_;
-    std::vector<int> frame_to_page_;
-    std::vector<bool> frame_modified_;
-    
-    // AI Integration
-    std::vector<int> recent_accesses_;
-    std::vector<int> recent_predictions_;
+    // AI Integration. The access history is a fixed lock-free ring the
+    // hot path appends to with two relaxed atomic ops; the predictor
+    // thread snapshots it, computes predictions and applies prefetches
+    // between access batches, so prediction work never runs under the
+    // access locks.
     static constexpr size_t MAX_RECENT_ACCESSES = 100;
+    static constexpr size_t HISTORY_CAPACITY = 1024;  // power of two
+    std::unique_ptr<std::atomic<int>[]> access_history_;
+    std::atomic<size_t> history_pos_{0};
+    std::vector<int> recent_predictions_;
     std::atomic<size_t> ai_predictions_made_{0};
     std::atomic<double> ai_prediction_confidence_{0.0};
+    std::thread predictor_thread_;
+    std::atomic<bool> predictor_running_{false};
+
+    // Shared-memory channel to an out-of-process predictor sidecar;
+    // null when unconfigured, in which case the predictor thread runs
+    // the built-in heuristic
+    std::unique_ptr<PredictorChannel> predictor_channel_;
+
+    // Background aging daemon (active/inactive policy only): moves
+    // frames between the hot and cold lists in bounded increments so
+    // victim selection stays O(1) on the fault path
+    std::thread aging_thread_;
+    std::atomic<bool> aging_running_{false};
     
-    // Thread safety
+    // Thread safety: mutex_ guards frame metadata and eviction, the
+    // per-space locks serialize the access stream of one address space,
+    // and replacement_mutex_ covers the (short) replacement bookkeeping
+    // on the hit path. structure_mutex_ protects the shape of the
+    // per-space state itself: accessors hold it shared while indexing
+    // into page_tables_/space_mutexes_/tlbs_, and setConfig holds it
+    // exclusive while initializeState tears those vectors down and
+    // rebuilds them — without it a reconfigure could destroy the very
+    // mutex an in-flight access is holding. Lock order is
+    // structure -> space -> mutex_ -> shard.
+    mutable std::shared_mutex structure_mutex_;
     mutable std::mutex mutex_;
+    mutable std::mutex replacement_mutex_;
+    mutable std::mutex ai_mutex_;
     std::atomic<bool> simulation_running_{false};
     
     // Event callback
     std::function<void(const VMMEvent&)> event_callback_;
 
+    // Binary event ring (hot-path events; drained and formatted off-thread)
+    std::unique_ptr<EventRingBuffer> event_ring_;
+    std::atomic<size_t> access_event_counter_{0};  // bumped from any space's driver
+
+    // Sampled working-set / reuse-distance / heat instrumentation
+    std::unique_ptr<Instrumentation> instrumentation_;
+
+    // Simulated swap device with latency model and async write-back
+    std::unique_ptr<SwapBackend> swap_backend_;
+
+    // Recorded-decision log: every access appended in the binary trace
+    // format (TRACE_WRITE_BIT | page), flushed on stopSimulation, so a
+    // captured run replays bit-for-bit through the TRACE workload
+    std::vector<uint32_t> access_log_;
+    mutable std::mutex log_mutex_;
+
 public:
     explicit VMM(const VMMConfig& config);
-    
+    ~VMM();
+
     // Core VMM operations
     bool accessPage(int page_number, bool is_write = false);
+    bool accessPage(int address_space, int page_number, bool is_write);
+    size_t accessBatch(const std::vector<PageAccess>& accesses);
+    size_t accessBatch(int address_space, const std::vector<PageAccess>& accesses);
+    size_t getAddressSpaceCount() const { return page_tables_.size(); }
+
+    // Fork-style copy-on-write sharing: maps every page resident in
+    // `parent` into `child` against the same frames, marking both sides
+    // COW. The first write to either side copies the page to a private
+    // frame (handleCOWWrite). Returns the number of pages shared.
+    size_t cloneAddressSpace(int parent, int child);
     void startSimulation();
     void stopSimulation();
     bool isSimulationRunning() const { return simulation_running_; }
@@ -100,17 +281,30 @@ public:
     size_t getSwapOuts() const;
     size_t getAIPredictions() const;
     size_t getAIHits() const;
+    size_t getTLBHits() const;
+    size_t getTLBMisses() const;
     double getPageFaultRate() const;
     double getAIHitRate() const;
     double getAIPredictionConfidence() const;
+    VMMMetricsSnapshot getMetricsSnapshot() const;
+    SwapMetricsSnapshot getSwapMetricsSnapshot() const;
     void resetMetrics();
     
     // Event handling
     void setEventCallback(std::function<void(const VMMEvent&)> callback);
+    size_t drainEventRecords(std::vector<EventRecord>& out, size_t max_records);
+    size_t getDroppedEventCount() const;
+
+    // Instrumentation (null when disabled via config)
+    const Instrumentation* getInstrumentation() const { return instrumentation_.get(); }
     
     // AI Integration
     std::vector<int> getRecentAccesses() const;
     void setAIPredictions(const std::vector<int>& predicted_pages);
+
+    // Offline-policy support: hand the full upcoming page stream to the
+    // replacement policy (used by OPT in benchmark/trace-replay mode)
+    void setFutureTrace(const std::vector<int>& future_pages);
     
     // Utility
     size_t getFreeFrameCount() const;
@@ -118,15 +312,33 @@ public:
     std::vector<int> getValidPages() const;
 
 private:
-    int allocateFrame();
+    void initializeState();
+    PageTable& pageTable(int address_space) { return *page_tables_[address_space]; }
+    const PageTable& pageTable(int address_space) const { return *page_tables_[address_space]; }
+    bool accessPageLocked(int address_space, int page_number, bool is_write);
+    int claimFrame(int address_space);
     void deallocateFrame(int frame_number);
-    int findFreeFrame() const;
-    void handlePageFault(int page_number, bool is_write);
+    int findFreeFrame(int shard_hint);
+    void handlePageFault(int address_space, int page_number, bool is_write);
+    int handleCOWWrite(int address_space, int page_number);
+    void removeSharer(int frame_number, int address_space, int page_number);
+    void unmapSharers(int frame_number);
+    void prefetchCluster(int address_space, int page_number, int stride);
     void swapIn(int page_number, int frame_number);
     void swapOut(int page_number, int frame_number);
     void emitEvent(const std::string& type, const std::string& message, const std::string& data = "");
+    size_t eventTimestamp() const;
+    void writeAccessLog();
+    void recordEvent(EventType type, int page, int frame, bool is_write = false);
     void updateRecentAccesses(int page_number);
-    std::vector<int> requestAIPredictions();
+    void predictorLoop();
+    std::vector<int> computePredictions(const std::vector<int>& history);
+    void applyPredictions(const std::vector<int>& predictions);
+    void startPredictorThread();
+    void stopPredictorThread();
+    void agingLoop();
+    void startAgingThread();
+    void stopAgingThread();
 };
 
 } // namespace vmm
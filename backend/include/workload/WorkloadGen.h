@@ -5,6 +5,7 @@
 #include <random>
 #include <functional>
 #include <atomic>
+#include <cstdint>
 
 namespace workload {
 
@@ -13,7 +14,24 @@ enum class WorkloadType {
     RANDOM,
     STRIDED,
     ZIPF,
-    WEBSERVER
+    WEBSERVER,
+    TRACE
+};
+
+// One phase of a phased workload program: run `type` (with its own
+// pattern parameters) for `duration` accesses, then move on. By default
+// control falls through to the next phase in program order, sticking on
+// the last one; jump_probability/jump_target add a probabilistic
+// branch, e.g. jump_target=0 with probability 0.5 loops the program
+// half the time.
+struct WorkloadPhase {
+    WorkloadType type = WorkloadType::RANDOM;
+    size_t duration = 0;
+    int stride = 1;
+    double zipf_alpha = 1.0;
+    double locality_factor = 0.8;
+    double jump_probability = 0.0;
+    int jump_target = -1;
 };
 
 struct WorkloadConfig {
@@ -24,6 +42,36 @@ struct WorkloadConfig {
     double zipf_alpha = 1.0;
     double locality_factor = 0.8;
     size_t working_set_size = 100;
+    uint64_t seed = 0;       // 0 = seed from random_device; nonzero = deterministic
+    std::string trace_file;  // binary trace to replay (TRACE type)
+
+    // Non-empty = phased program: overrides `type` and sequences the
+    // listed phases; total_requests still caps the overall run
+    std::vector<WorkloadPhase> phases;
+};
+
+// Binary trace format: one little-endian uint32 per record. Bit 31 is
+// the read/write flag, bits 0-30 are the page number. The file is
+// memory-mapped and streamed in place, so replaying billions of records
+// costs no per-record allocation or parsing.
+constexpr uint32_t TRACE_WRITE_BIT = 0x80000000u;
+constexpr uint32_t TRACE_PAGE_MASK = 0x7FFFFFFFu;
+
+// Walker/Vose alias-method sampler: build() preprocesses an arbitrary
+// discrete distribution in O(n); sample() then draws in O(1) — one
+// uniform index plus one biased coin flip. Used for the Zipf workload
+// (previously O(page_range) per draw) and for working-set selection.
+class AliasSampler {
+private:
+    std::vector<double> prob_;
+    std::vector<int> alias_;
+
+public:
+    void build(const std::vector<double>& weights);
+    void clear();
+    bool empty() const { return prob_.empty(); }
+    size_t size() const { return prob_.size(); }
+    int sample(std::mt19937& rng) const;
 };
 
 class WorkloadGenerator {
@@ -34,14 +82,32 @@ private:
     std::function<void(int, bool)> access_callback_;
     std::function<void()> completion_callback_;
     
+    // Phase-engine state: index into config_.phases and accesses
+    // generated within the current phase
+    size_t phase_index_ = 0;
+    size_t phase_position_ = 0;
+    std::function<void(size_t, const WorkloadPhase&)> phase_callback_;
+
     // Workload-specific state
     size_t current_position_ = 0;
     std::vector<int> working_set_;
     std::uniform_int_distribution<int> random_dist_;
     std::uniform_real_distribution<double> prob_dist_;
 
+    // Precomputed samplers (rebuilt on setConfig/reset)
+    AliasSampler zipf_sampler_;
+    AliasSampler working_set_sampler_;
+
+    // Trace replay state (memory-mapped file)
+    const uint32_t* trace_records_ = nullptr;
+    size_t trace_count_ = 0;
+    size_t trace_position_ = 0;
+    void* trace_mapping_ = nullptr;
+    size_t trace_mapping_size_ = 0;
+
 public:
     explicit WorkloadGenerator(const WorkloadConfig& config);
+    ~WorkloadGenerator();
     
     // Configuration
     void setConfig(const WorkloadConfig& config);
@@ -55,10 +121,20 @@ public:
     // Callbacks
     void setAccessCallback(std::function<void(int, bool)> callback);
     void setCompletionCallback(std::function<void()> callback);
+
+    // Invoked at every phase boundary with the index and definition of
+    // the phase being entered (phase-change markers for benchmarks and
+    // the event stream)
+    void setPhaseCallback(std::function<void(size_t, const WorkloadPhase&)> callback);
+    size_t getCurrentPhase() const { return phase_index_; }
     
     // Workload generation
     void generateNextAccess();
     std::vector<int> generateBatch(size_t batch_size);
+    // Variant that also reports each access's write bit (parallel to the
+    // returned pages); trace replay decodes it from the record, other
+    // workload types are read-only in batch mode
+    std::vector<int> generateBatch(size_t batch_size, std::vector<bool>& write_mask);
     
     // Workload-specific methods
     int generateSequentialAccess();
@@ -66,12 +142,20 @@ public:
     int generateStridedAccess();
     int generateZipfAccess();
     int generateWebserverAccess();
+    int generateTraceAccess(bool& is_write);
+    size_t getTraceLength() const { return trace_count_; }
     
     // Utility
     void reset();
     std::string getWorkloadDescription() const;
 
 private:
+    void seedRng();
+    void applyPhase(size_t index);
+    void advancePhaseIfDue();
+    void buildZipfSampler();
+    void openTrace();
+    void closeTrace();
     void initializeWorkingSet();
     void updateWorkingSet(int page);
     int selectFromWorkingSet();
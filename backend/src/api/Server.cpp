@@ -1,6 +1,8 @@
 #include "api/Server.h"
+#include <chrono>
 #include <iostream>
 #include <sstream>
+#include <string_view>
 #include <algorithm>
 #include <cctype>
 #include <iomanip>
@@ -15,6 +17,12 @@
 #include <arpa/inet.h>
 #include <unistd.h>
 #include <fcntl.h>
+#include <cerrno>
+#endif
+
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
 #endif
 
 namespace api {
@@ -63,12 +71,49 @@ void SimpleHTTPServer::setEventCallback(std::function<void(const std::string&)>
 }
 
 void SimpleHTTPServer::emitEvent(const std::string& event_data) {
+#ifdef __linux__
+    if (use_event_loop_) {
+        // Hand the event to the loop thread; it appends to each SSE
+        // subscriber's write buffer without blocking the caller
+        {
+            std::lock_guard<std::mutex> lock(broadcast_mutex_);
+            pending_broadcasts_.push_back(event_data);
+        }
+        if (wakeup_fd_ != -1) {
+            uint64_t one = 1;
+            ssize_t written = write(wakeup_fd_, &one, sizeof(one));
+            (void)written;
+        }
+        if (event_callback_) {
+            event_callback_(event_data);
+        }
+        return;
+    }
+#endif
+    // Fan out to every SSE subscriber's own bounded queue
+    {
+        std::lock_guard<std::mutex> lock(subscribers_mutex_);
+        for (auto& subscriber : subscribers_) {
+            std::lock_guard<std::mutex> sub_lock(subscriber->mutex);
+            if (subscriber->queue.size() >= max_subscriber_queue_) {
+                subscriber->queue.pop_front();
+                subscriber->dropped++;
+            }
+            subscriber->queue.push_back(event_data);
+            subscriber->cv.notify_one();
+        }
+    }
+
+    // Legacy polling queue (getNextEvent/hasEvents), bounded the same way
     {
         std::lock_guard<std::mutex> lock(event_mutex_);
+        if (events_.size() >= max_subscriber_queue_) {
+            events_.pop();
+        }
         events_.push(event_data);
     }
     event_cv_.notify_all();
-    
+
     if (event_callback_) {
         event_callback_(event_data);
     }
@@ -131,7 +176,15 @@ void SimpleHTTPServer::serverLoop() {
     }
     
     std::cout << "Server listening on port " << port_ << std::endl;
-    
+
+#ifdef __linux__
+    if (use_event_loop_) {
+        eventLoop(server_socket);
+        close(server_socket);
+        return;
+    }
+#endif
+
     while (running_) {
         sockaddr_in client_addr;
         socklen_t client_len = sizeof(client_addr);
@@ -155,35 +208,365 @@ void SimpleHTTPServer::serverLoop() {
 #endif
 }
 
-void SimpleHTTPServer::handleConnection(int client_socket) {
+#ifdef __linux__
+
+namespace {
+void setNonBlocking(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    if (flags != -1) {
+        fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+    }
+}
+} // namespace
+
+void SimpleHTTPServer::eventLoop(int server_socket) {
+    epoll_fd_ = epoll_create1(0);
+    if (epoll_fd_ < 0) {
+        std::cerr << "Failed to create epoll instance" << std::endl;
+        return;
+    }
+
+    wakeup_fd_ = eventfd(0, EFD_NONBLOCK);
+    setNonBlocking(server_socket);
+
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.fd = server_socket;
+    epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, server_socket, &ev);
+
+    if (wakeup_fd_ != -1) {
+        epoll_event wev{};
+        wev.events = EPOLLIN;
+        wev.data.fd = wakeup_fd_;
+        epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, wakeup_fd_, &wev);
+    }
+
+    constexpr int MAX_EVENTS = 64;
+    epoll_event events[MAX_EVENTS];
+
+    while (running_) {
+        int ready = epoll_wait(epoll_fd_, events, MAX_EVENTS, 500);
+        if (ready < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+
+        closeIdleConnections();
+
+        for (int i = 0; i < ready; ++i) {
+            int fd = events[i].data.fd;
+
+            if (fd == server_socket) {
+                acceptConnections(server_socket);
+                continue;
+            }
+            if (fd == wakeup_fd_) {
+                uint64_t drained;
+                while (read(wakeup_fd_, &drained, sizeof(drained)) > 0) {
+                }
+                distributeBroadcasts();
+                continue;
+            }
+
+            auto it = connections_.find(fd);
+            if (it == connections_.end()) {
+                continue;
+            }
+            Connection& conn = it->second;
+
+            if (events[i].events & (EPOLLHUP | EPOLLERR)) {
+                closeConnection(fd);
+                continue;
+            }
+            if (events[i].events & EPOLLIN) {
+                handleReadable(conn);
+                if (connections_.find(fd) == connections_.end()) {
+                    continue; // closed during read
+                }
+            }
+            if (events[i].events & EPOLLOUT) {
+                handleWritable(conn);
+            }
+        }
+    }
+
+    // Shut down remaining connections
+    std::vector<int> open_fds;
+    for (const auto& pair : connections_) {
+        open_fds.push_back(pair.first);
+    }
+    for (int fd : open_fds) {
+        closeConnection(fd);
+    }
+    if (wakeup_fd_ != -1) {
+        close(wakeup_fd_);
+        wakeup_fd_ = -1;
+    }
+    close(epoll_fd_);
+    epoll_fd_ = -1;
+}
+
+void SimpleHTTPServer::acceptConnections(int server_socket) {
+    while (true) {
+        sockaddr_in client_addr;
+        socklen_t client_len = sizeof(client_addr);
+        int client_socket = accept(server_socket, (sockaddr*)&client_addr, &client_len);
+        if (client_socket < 0) {
+            break; // EAGAIN or error: nothing more to accept
+        }
+
+        setNonBlocking(client_socket);
+        Connection conn;
+        conn.fd = client_socket;
+        conn.last_activity = std::chrono::steady_clock::now();
+        connections_[client_socket] = std::move(conn);
+
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.fd = client_socket;
+        epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, client_socket, &ev);
+    }
+}
+
+void SimpleHTTPServer::handleReadable(Connection& conn) {
     char buffer[4096];
-    std::string request_data;
-    
-    int bytes_received = recv(client_socket, buffer, sizeof(buffer) - 1, 0);
-    if (bytes_received > 0) {
-        buffer[bytes_received] = '\0';
-        request_data = buffer;
+    while (true) {
+        ssize_t bytes = recv(conn.fd, buffer, sizeof(buffer), 0);
+        if (bytes > 0) {
+            conn.read_buffer.append(buffer, bytes);
+            continue;
+        }
+        if (bytes == 0) {
+            closeConnection(conn.fd);
+            return;
+        }
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            break;
+        }
+        closeConnection(conn.fd);
+        return;
     }
-    
-    HTTPRequest request = parseRequest(request_data);
-    HTTPResponse response;
-    
-    // Handle SSE endpoint
-    if (request.path == "/events/stream") {
-        handleSSEConnection(client_socket);
+
+    // Drain every complete request already buffered (keep-alive clients
+    // may pipeline several); responses queue up in the write buffer in
+    // order. erase() keeps the buffer's capacity, so steady-state
+    // requests on this connection allocate nothing.
+    while (true) {
+        HTTPRequest request;
+        size_t consumed = 0;
+        if (!tryParseRequest(conn.read_buffer, request, consumed)) {
+            if (conn.read_buffer.size() > MAX_REQUEST_BYTES) {
+                closeConnection(conn.fd); // oversized or garbage request
+                return;
+            }
+            break;
+        }
+        conn.read_buffer.erase(0, consumed);
+        conn.last_activity = std::chrono::steady_clock::now();
+
+        if (request.path == "/events/stream") {
+            // Upgrade the connection to an SSE subscriber: send the
+            // stream headers and keep the fd registered for broadcasts
+            conn.is_sse = true;
+            conn.write_buffer +=
+                "HTTP/1.1 200 OK\r\n"
+                "Content-Type: text/event-stream\r\n"
+                "Cache-Control: no-cache\r\n"
+                "Connection: keep-alive\r\n"
+                "Access-Control-Allow-Origin: *\r\n"
+                "\r\n";
+            break;
+        }
+
+        HTTPResponse response;
+        if (request_handler_) {
+            request_handler_(request, response);
+        } else {
+            response.status_code = 404;
+            response.body = "Not Found";
+        }
+
+        // HTTP/1.1 default is keep-alive; only an explicit
+        // "Connection: close" ends the connection after this response
+        bool keep_alive = wantsKeepAlive(request);
+        response.headers["Connection"] = keep_alive ? "keep-alive" : "close";
+        conn.write_buffer += buildResponse(response);
+        if (!keep_alive) {
+            conn.close_after_write = true;
+            break;
+        }
+    }
+    updateInterest(conn);
+}
+
+void SimpleHTTPServer::closeIdleConnections() {
+    // SSE streams stay open indefinitely; only plain keep-alive
+    // connections are subject to the read deadline
+    auto now = std::chrono::steady_clock::now();
+    std::vector<int> idle_fds;
+    for (const auto& pair : connections_) {
+        const Connection& conn = pair.second;
+        if (conn.is_sse || !conn.write_buffer.empty()) {
+            continue;
+        }
+        auto idle_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+            now - conn.last_activity).count();
+        if (idle_ms > KEEP_ALIVE_TIMEOUT_MS) {
+            idle_fds.push_back(pair.first);
+        }
+    }
+    for (int fd : idle_fds) {
+        closeConnection(fd);
+    }
+}
+
+void SimpleHTTPServer::handleWritable(Connection& conn) {
+    while (!conn.write_buffer.empty()) {
+        ssize_t sent = send(conn.fd, conn.write_buffer.data(), conn.write_buffer.size(), MSG_NOSIGNAL);
+        if (sent > 0) {
+            conn.write_buffer.erase(0, sent);
+            continue;
+        }
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            return; // socket full, stay subscribed for EPOLLOUT
+        }
+        closeConnection(conn.fd);
         return;
     }
-    
-    // Handle regular requests
-    if (request_handler_) {
-        request_handler_(request, response);
+
+    refillWriteBuffer(conn);
+    if (conn.write_buffer.empty() && conn.close_after_write) {
+        closeConnection(conn.fd);
     } else {
-        response.status_code = 404;
-        response.body = "Not Found";
+        updateInterest(conn);
     }
-    
-    sendResponse(client_socket, response);
-    
+}
+
+void SimpleHTTPServer::updateInterest(Connection& conn) {
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    if (!conn.write_buffer.empty()) {
+        ev.events |= EPOLLOUT;
+    }
+    ev.data.fd = conn.fd;
+    epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, conn.fd, &ev);
+}
+
+void SimpleHTTPServer::closeConnection(int fd) {
+    epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
+    close(fd);
+    connections_.erase(fd);
+}
+
+void SimpleHTTPServer::distributeBroadcasts() {
+    std::vector<std::string> broadcasts;
+    {
+        std::lock_guard<std::mutex> lock(broadcast_mutex_);
+        broadcasts.swap(pending_broadcasts_);
+    }
+    if (broadcasts.empty()) {
+        return;
+    }
+
+    for (auto& pair : connections_) {
+        Connection& conn = pair.second;
+        if (!conn.is_sse) {
+            continue;
+        }
+        // Queue per subscriber, drop-oldest when the client stalls
+        for (const auto& event : broadcasts) {
+            if (conn.sse_queue.size() >= max_subscriber_queue_) {
+                conn.sse_queue.pop_front();
+                conn.sse_dropped++;
+            }
+            conn.sse_queue.push_back(event);
+        }
+        refillWriteBuffer(conn);
+        updateInterest(conn);
+    }
+}
+
+void SimpleHTTPServer::refillWriteBuffer(Connection& conn) {
+    // Move queued events into the socket write buffer in chunks; the
+    // queue holds the backlog so the buffer itself stays small
+    while (!conn.sse_queue.empty() && conn.write_buffer.size() < 64 * 1024) {
+        conn.write_buffer += "data: " + conn.sse_queue.front() + "\n\n";
+        conn.sse_queue.pop_front();
+    }
+}
+
+#endif // __linux__
+
+void SimpleHTTPServer::handleConnection(int client_socket) {
+    // Keep-alive loop: serve requests off this socket until the client
+    // sends "Connection: close", disconnects, or goes idle past the
+    // read deadline. The read buffer is reused across requests, so a
+    // polling client's steady state allocates nothing.
+#ifdef _WIN32
+    DWORD timeout_ms = KEEP_ALIVE_TIMEOUT_MS;
+    setsockopt(client_socket, SOL_SOCKET, SO_RCVTIMEO,
+               (const char*)&timeout_ms, sizeof(timeout_ms));
+#else
+    timeval timeout{};
+    timeout.tv_sec = KEEP_ALIVE_TIMEOUT_MS / 1000;
+    timeout.tv_usec = (KEEP_ALIVE_TIMEOUT_MS % 1000) * 1000;
+    setsockopt(client_socket, SOL_SOCKET, SO_RCVTIMEO,
+               (const char*)&timeout, sizeof(timeout));
+#endif
+
+    char buffer[4096];
+    std::string request_data;
+    bool alive = true;
+
+    while (running_ && alive) {
+        // Read until a complete request (headers + Content-Length body)
+        // has arrived; pipelined requests may already be buffered
+        HTTPRequest request;
+        size_t consumed = 0;
+        bool complete = tryParseRequest(request_data, request, consumed);
+        while (!complete && alive) {
+            if (request_data.size() > MAX_REQUEST_BYTES) {
+                alive = false; // oversized or garbage request
+                break;
+            }
+            int bytes_received = recv(client_socket, buffer, sizeof(buffer), 0);
+            if (bytes_received <= 0) {
+                alive = false; // client closed, errored, or hit the deadline
+                break;
+            }
+            request_data.append(buffer, bytes_received);
+            complete = tryParseRequest(request_data, request, consumed);
+        }
+        if (!alive) {
+            break;
+        }
+        request_data.erase(0, consumed);
+
+        // Handle SSE endpoint: the subscriber loop owns the socket from
+        // here and never returns to the keep-alive loop
+        if (request.path == "/events/stream") {
+            handleSSEConnection(client_socket);
+            break;
+        }
+
+        HTTPResponse response;
+        if (request_handler_) {
+            request_handler_(request, response);
+        } else {
+            response.status_code = 404;
+            response.body = "Not Found";
+        }
+
+        bool keep_alive = wantsKeepAlive(request);
+        response.headers["Connection"] = keep_alive ? "keep-alive" : "close";
+        sendResponse(client_socket, response);
+        if (!keep_alive) {
+            break;
+        }
+    }
+
 #ifdef _WIN32
     closesocket(client_socket);
 #else
@@ -191,46 +574,107 @@ void SimpleHTTPServer::handleConnection(int client_socket) {
 #endif
 }
 
-HTTPRequest SimpleHTTPServer::parseRequest(const std::string& request_data) {
-    HTTPRequest request;
-    std::istringstream stream(request_data);
-    std::string line;
-    
-    // Parse request line
-    if (std::getline(stream, line)) {
-        std::istringstream line_stream(line);
-        line_stream >> request.method >> request.path;
+namespace {
+
+std::string_view trimView(std::string_view view) {
+    size_t begin = view.find_first_not_of(" \t");
+    if (begin == std::string_view::npos) {
+        return {};
     }
-    
-    // Parse headers
-    while (std::getline(stream, line) && line != "\r") {
-        size_t colon_pos = line.find(':');
-        if (colon_pos != std::string::npos) {
-            std::string key = line.substr(0, colon_pos);
-            std::string value = line.substr(colon_pos + 1);
-            
-            // Trim whitespace
-            key.erase(0, key.find_first_not_of(" \t"));
-            key.erase(key.find_last_not_of(" \t\r") + 1);
-            value.erase(0, value.find_first_not_of(" \t"));
-            value.erase(value.find_last_not_of(" \t\r") + 1);
-            
-            request.headers[key] = value;
+    size_t end = view.find_last_not_of(" \t\r");
+    return view.substr(begin, end - begin + 1);
+}
+
+bool iequals(std::string_view a, std::string_view b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (std::tolower(static_cast<unsigned char>(a[i])) !=
+            std::tolower(static_cast<unsigned char>(b[i]))) {
+            return false;
         }
     }
-    
-    // Parse body
-    std::string body_line;
-    bool first_line = true;
-    while (std::getline(stream, body_line)) {
-        if (!first_line) {
-            request.body += "\n";
+    return true;
+}
+
+} // namespace
+
+// HTTP/1.1 semantics: connections persist unless the client asks for
+// "Connection: close". (HTTP/1.0 clients that want keep-alive send the
+// header explicitly, which also works here.)
+bool SimpleHTTPServer::wantsKeepAlive(const HTTPRequest& request) {
+    for (const auto& header : request.headers) {
+        if (iequals(header.first, "Connection")) {
+            return !iequals(header.second, "close");
         }
-        request.body += body_line;
-        first_line = false;
     }
-    
-    return request;
+    return true;
+}
+
+// Incremental request parser: returns false while the buffer does not
+// yet hold a complete request (headers plus Content-Length bytes of
+// body), so callers keep reading and retry. Headers are sliced in
+// place with string_views over the connection's reused buffer — the
+// only copies made are the map entries and the body itself, with no
+// stringstream or per-line allocation.
+bool SimpleHTTPServer::tryParseRequest(const std::string& buffer, HTTPRequest& request, size_t& consumed) {
+    std::string_view data(buffer);
+
+    size_t header_end = data.find("\r\n\r\n");
+    if (header_end == std::string_view::npos) {
+        return false;
+    }
+
+    // Request line
+    size_t line_end = data.find("\r\n");
+    std::string_view request_line = data.substr(0, line_end);
+    size_t method_end = request_line.find(' ');
+    if (method_end == std::string_view::npos) {
+        // Malformed; consume the block so the connection can recover
+        consumed = header_end + 4;
+        return true;
+    }
+    size_t path_end = request_line.find(' ', method_end + 1);
+    request.method = std::string(request_line.substr(0, method_end));
+    request.path = std::string(path_end == std::string_view::npos
+        ? request_line.substr(method_end + 1)
+        : request_line.substr(method_end + 1, path_end - method_end - 1));
+
+    // Headers, one view per line
+    size_t content_length = 0;
+    size_t pos = line_end + 2;
+    while (pos < header_end) {
+        size_t next = data.find("\r\n", pos);
+        std::string_view header_line = data.substr(pos, next - pos);
+        pos = next + 2;
+
+        size_t colon = header_line.find(':');
+        if (colon == std::string_view::npos) {
+            continue;
+        }
+        std::string_view key = trimView(header_line.substr(0, colon));
+        std::string_view value = trimView(header_line.substr(colon + 1));
+        if (iequals(key, "Content-Length")) {
+            content_length = 0;
+            for (char c : value) {
+                if (c < '0' || c > '9') {
+                    break;
+                }
+                content_length = content_length * 10 + (c - '0');
+            }
+        }
+        request.headers[std::string(key)] = std::string(value);
+    }
+
+    // Body: wait until Content-Length bytes have arrived
+    size_t body_start = header_end + 4;
+    if (buffer.size() < body_start + content_length) {
+        return false;
+    }
+    request.body = buffer.substr(body_start, content_length);
+    consumed = body_start + content_length;
+    return true;
 }
 
 std::string SimpleHTTPServer::buildResponse(const HTTPResponse& response) {
@@ -274,22 +718,40 @@ void SimpleHTTPServer::handleSSEConnection(int client_socket) {
         "\r\n";
     
     send(client_socket, sse_headers.c_str(), sse_headers.length(), 0);
-    
-    // Send events
-    while (running_) {
-        std::unique_lock<std::mutex> lock(event_mutex_);
-        event_cv_.wait(lock, [this] { return !events_.empty() || !running_; });
-        
-        if (!running_) break;
-        
-        while (!events_.empty()) {
-            std::string event = events_.front();
-            events_.pop();
-            
+
+    // Register a dedicated subscriber so this client sees the full
+    // stream regardless of how many others are connected
+    auto subscriber = std::make_shared<SSESubscriber>();
+    {
+        std::lock_guard<std::mutex> lock(subscribers_mutex_);
+        subscribers_.push_back(subscriber);
+    }
+
+    bool client_alive = true;
+    while (running_ && client_alive) {
+        std::deque<std::string> batch;
+        {
+            std::unique_lock<std::mutex> lock(subscriber->mutex);
+            subscriber->cv.wait_for(lock, std::chrono::milliseconds(500),
+                                    [&] { return !subscriber->queue.empty() || !running_; });
+            batch.swap(subscriber->queue);
+        }
+
+        for (const std::string& event : batch) {
             std::string sse_event = "data: " + event + "\n\n";
-            send(client_socket, sse_event.c_str(), sse_event.length(), 0);
+            if (send(client_socket, sse_event.c_str(), sse_event.length(), 0) < 0) {
+                client_alive = false;
+                break;
+            }
         }
     }
+
+    // Unregister before the socket is closed by the caller
+    {
+        std::lock_guard<std::mutex> lock(subscribers_mutex_);
+        subscribers_.erase(std::remove(subscribers_.begin(), subscribers_.end(), subscriber),
+                           subscribers_.end());
+    }
 }
 
 std::string SimpleHTTPServer::urlDecode(const std::string& str) const {
@@ -388,7 +850,14 @@ JSONBuilder& JSONBuilder::addString(const std::string& value) {
 }
 
 JSONBuilder& JSONBuilder::addNumber(double value) {
-    json_ << value;
+    // Emit integral values (counters, timestamps) without the default
+    // scientific notation that large doubles would otherwise get
+    long long integral = static_cast<long long>(value);
+    if (static_cast<double>(integral) == value) {
+        json_ << integral;
+    } else {
+        json_ << value;
+    }
     return *this;
 }
 
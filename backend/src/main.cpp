@@ -5,8 +5,11 @@
 #include <signal.h>
 #include <algorithm>
 #include <atomic>
+#include <fstream>
+#include <sstream>
 
 #include "vmm/VMM.h"
+#include "vmm/RunRecorder.h"
 #include "workload/WorkloadGen.h"
 #include "api/Server.h"
 
@@ -21,14 +24,24 @@ private:
     std::unique_ptr<SimpleHTTPServer> server_;
     
     std::thread simulation_thread_;
+    std::thread event_drainer_thread_;
     std::atomic<bool> simulation_running_{false};
     std::atomic<bool> server_running_{false};
+    std::atomic<bool> drainer_running_{false};
     
     VMMConfig vmm_config_;
     WorkloadConfig workload_config_;
 
+    // Cached /metrics rendering: monitoring collectors poll at 10Hz from
+    // several hosts, so the JSON is rebuilt at most once per staleness
+    // window instead of per request
+    std::mutex metrics_cache_mutex_;
+    std::string metrics_cache_;
+    std::chrono::steady_clock::time_point metrics_cache_time_;
+    int metrics_max_staleness_ms_ = 100;
+
 public:
-    VMMSimulator() {
+    explicit VMMSimulator(const std::string& predictor_shm = "") {
         // Initialize VMM with default config
         vmm_config_.total_frames = 256;
         vmm_config_.page_size = 4096;
@@ -36,6 +49,7 @@ public:
         vmm_config_.replacement_policy = ReplacementPolicy::CLOCK;
         vmm_config_.enable_ai_predictions = true;
         vmm_config_.ai_predictor_url = "http://localhost:5001/predict";
+        vmm_config_.ai_predictor_shm = predictor_shm;
         
         // Initialize workload with default config
         workload_config_.type = WorkloadType::RANDOM;
@@ -76,10 +90,14 @@ public:
         // Start VMM simulation
         vmm_->startSimulation();
         std::cout << "VMM simulation started" << std::endl;
+
+        // Start event drainer (formats binary event records off the hot path)
+        startEventDrainer();
     }
-    
+
     void stop() {
         stopSimulation();
+        stopEventDrainer();
         if (server_running_) {
             server_->stop();
             server_running_ = false;
@@ -99,6 +117,14 @@ private:
             vmm_->accessPage(page, is_write);
         });
         
+        // Phase-boundary markers from phased workload programs go out
+        // on the same event stream the frontend already consumes
+        workload_gen_->setPhaseCallback([this](size_t index, const WorkloadPhase& phase) {
+            VMMEvent event("PHASE", "Workload entered phase " + std::to_string(index) +
+                           " (" + std::to_string(phase.duration) + " accesses)");
+            server_->emitEvent(buildEventJSON(event));
+        });
+
         // Workload completion handler
         workload_gen_->setCompletionCallback([this]() {
             std::cout << "Workload completed, restarting..." << std::endl;
@@ -130,6 +156,9 @@ private:
         if (request.method == "GET" && request.path == "/metrics") {
             handleGetMetrics(response);
         }
+        else if (request.method == "GET" && request.path == "/metrics/histograms") {
+            handleGetHistograms(response);
+        }
         else if (request.method == "POST" && request.path == "/simulate/start") {
             handleStartSimulation(request, response);
         }
@@ -147,32 +176,126 @@ private:
     }
     
     void handleGetMetrics(HTTPResponse& response) {
+        std::lock_guard<std::mutex> lock(metrics_cache_mutex_);
+
+        auto now = std::chrono::steady_clock::now();
+        auto age = std::chrono::duration_cast<std::chrono::milliseconds>(
+            now - metrics_cache_time_).count();
+        if (!metrics_cache_.empty() && age < metrics_max_staleness_ms_) {
+            response.body = metrics_cache_;
+            return;
+        }
+
+        // One lock-free snapshot of the atomic counters, rendered once
+        VMMMetricsSnapshot snapshot = vmm_->getMetricsSnapshot();
+        SwapMetricsSnapshot swap = vmm_->getSwapMetricsSnapshot();
         JSONBuilder json;
         json.startObject()
-            .addKey("total_accesses").addNumber(static_cast<double>(vmm_->getTotalAccesses()))
+            .addKey("total_accesses").addNumber(static_cast<double>(snapshot.total_accesses))
+            .addComma()
+            .addKey("page_faults").addNumber(static_cast<double>(snapshot.page_faults))
+            .addComma()
+            .addKey("page_fault_rate").addNumber(snapshot.page_fault_rate)
+            .addComma()
+            .addKey("swap_ins").addNumber(static_cast<double>(snapshot.swap_ins))
             .addComma()
-            .addKey("page_faults").addNumber(static_cast<double>(vmm_->getPageFaults()))
+            .addKey("swap_outs").addNumber(static_cast<double>(snapshot.swap_outs))
             .addComma()
-            .addKey("page_fault_rate").addNumber(vmm_->getPageFaultRate())
+            .addKey("ai_predictions").addNumber(static_cast<double>(snapshot.ai_predictions))
             .addComma()
-            .addKey("swap_ins").addNumber(static_cast<double>(vmm_->getSwapIns()))
+            .addKey("ai_hit_rate").addNumber(snapshot.ai_hit_rate)
             .addComma()
-            .addKey("swap_outs").addNumber(static_cast<double>(vmm_->getSwapOuts()))
+            .addKey("ai_prediction_confidence").addNumber(snapshot.ai_prediction_confidence)
             .addComma()
-            .addKey("ai_predictions").addNumber(static_cast<double>(vmm_->getAIPredictions()))
+            .addKey("tlb_hits").addNumber(static_cast<double>(snapshot.tlb_hits))
             .addComma()
-            .addKey("ai_hit_rate").addNumber(vmm_->getAIHitRate())
+            .addKey("tlb_misses").addNumber(static_cast<double>(snapshot.tlb_misses))
             .addComma()
-            .addKey("ai_prediction_confidence").addNumber(vmm_->getAIPredictionConfidence())
+            .addKey("tlb_hit_rate").addNumber(snapshot.tlb_hit_rate)
             .addComma()
-            .addKey("free_frames").addNumber(static_cast<double>(vmm_->getFreeFrameCount()))
+            .addKey("cluster_prefetches").addNumber(static_cast<double>(snapshot.cluster_prefetches))
             .addComma()
-            .addKey("used_frames").addNumber(static_cast<double>(vmm_->getUsedFrameCount()))
+            .addKey("numa_local_allocations").addNumber(static_cast<double>(snapshot.numa_local_allocations))
+            .addComma()
+            .addKey("numa_remote_allocations").addNumber(static_cast<double>(snapshot.numa_remote_allocations))
+            .addComma()
+            .addKey("cow_breaks").addNumber(static_cast<double>(snapshot.cow_breaks))
+            .addComma()
+            .addKey("cow_shared_mappings").addNumber(static_cast<double>(snapshot.cow_shared_mappings))
+            .addComma()
+            .addKey("dedup_ratio").addNumber(snapshot.dedup_ratio)
+            .addComma()
+            .addKey("free_frames").addNumber(static_cast<double>(snapshot.free_frames))
+            .addComma()
+            .addKey("used_frames").addNumber(static_cast<double>(snapshot.used_frames))
+            .addComma()
+            .addKey("swap_queue_depth").addNumber(static_cast<double>(swap.queue_depth))
+            .addComma()
+            .addKey("swap_max_queue_depth").addNumber(static_cast<double>(swap.max_queue_depth))
+            .addComma()
+            .addKey("swap_write_stalls").addNumber(static_cast<double>(swap.write_stalls))
+            .addComma()
+            .addKey("simulated_swap_ms").addNumber(swap.simulated_total_ms)
             .endObject();
-        
-        response.body = json.build();
+
+        metrics_cache_ = json.build();
+        metrics_cache_time_ = now;
+        response.body = metrics_cache_;
     }
     
+    void handleGetHistograms(HTTPResponse& response) {
+        const Instrumentation* instr = vmm_->getInstrumentation();
+        if (instr == nullptr) {
+            response.status_code = 404;
+            response.body = "{\"error\": \"Instrumentation disabled\"}";
+            return;
+        }
+
+        std::vector<size_t> reuse = instr->getReuseDistanceHistogram();
+        auto working_set = instr->getWorkingSetCurve();
+        auto top_pages = instr->getTopPages(50);
+
+        JSONBuilder json;
+        json.startObject()
+            .addKey("sample_interval").addNumber(static_cast<double>(instr->getSampleInterval()))
+            .addComma()
+            .addKey("sampled_accesses").addNumber(static_cast<double>(instr->getSampledAccessCount()))
+            .addComma();
+
+        // Log2 buckets: bucket i counts reuses at distance ~2^i
+        json.addKey("reuse_distance_log2").startArray();
+        for (size_t i = 0; i < reuse.size(); ++i) {
+            if (i > 0) json.addComma();
+            json.addNumber(static_cast<double>(reuse[i]));
+        }
+        json.endArray().addComma();
+
+        json.addKey("working_set").startArray();
+        for (size_t i = 0; i < working_set.size(); ++i) {
+            if (i > 0) json.addComma();
+            json.startObject()
+                .addKey("access").addNumber(static_cast<double>(working_set[i].first))
+                .addComma()
+                .addKey("size").addNumber(static_cast<double>(working_set[i].second))
+                .endObject();
+        }
+        json.endArray().addComma();
+
+        json.addKey("top_pages").startArray();
+        for (size_t i = 0; i < top_pages.size(); ++i) {
+            if (i > 0) json.addComma();
+            json.startObject()
+                .addKey("page").addNumber(static_cast<double>(top_pages[i].first))
+                .addComma()
+                .addKey("heat").addNumber(static_cast<double>(top_pages[i].second))
+                .endObject();
+        }
+        json.endArray();
+
+        json.endObject();
+        response.body = json.build();
+    }
+
     void handleStartSimulation(const HTTPRequest& request, HTTPResponse& response) {
         // Parse request body for workload configuration
         std::string mode = "prefetch_only";
@@ -313,6 +436,85 @@ private:
         }
     }
     
+    void startEventDrainer() {
+        if (drainer_running_) {
+            return;
+        }
+        drainer_running_ = true;
+        event_drainer_thread_ = std::thread([this]() {
+            std::vector<EventRecord> records;
+            records.reserve(256);
+            while (drainer_running_) {
+                records.clear();
+                if (vmm_->drainEventRecords(records, 256) == 0) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                    continue;
+                }
+                for (const auto& record : records) {
+                    server_->emitEvent(buildRecordJSON(record));
+                }
+            }
+        });
+    }
+
+    void stopEventDrainer() {
+        if (drainer_running_) {
+            drainer_running_ = false;
+            if (event_drainer_thread_.joinable()) {
+                event_drainer_thread_.join();
+            }
+        }
+    }
+
+    // Format a binary event record into the same JSON shape the frontend
+    // already consumes. This runs on the drainer thread, never on the
+    // simulation hot path.
+    std::string buildRecordJSON(const EventRecord& record) {
+        std::string type;
+        std::string message;
+        switch (record.type) {
+            case EventType::ACCESS:
+                type = "ACCESS";
+                message = "Page " + std::to_string(record.page) +
+                          (record.is_write ? " (write)" : " (read)");
+                break;
+            case EventType::FAULT:
+                type = "FAULT";
+                message = "Page fault for page " + std::to_string(record.page);
+                break;
+            case EventType::EVICT:
+                type = "EVICT";
+                message = "Evicted page " + std::to_string(record.page) +
+                          " from frame " + std::to_string(record.frame);
+                break;
+            case EventType::SWAP_IN:
+                type = "SWAP_IN";
+                message = "Swapped in page " + std::to_string(record.page) +
+                          " to frame " + std::to_string(record.frame);
+                break;
+            case EventType::SWAP_OUT:
+                type = "SWAP_OUT";
+                message = "Swapped out page " + std::to_string(record.page) +
+                          " from frame " + std::to_string(record.frame);
+                break;
+            case EventType::COW_BREAK:
+                type = "COW_BREAK";
+                message = "Copied page " + std::to_string(record.page) +
+                          " to private frame " + std::to_string(record.frame);
+                break;
+        }
+
+        JSONBuilder json;
+        json.startObject()
+            .addKey("type").addString(type)
+            .addComma()
+            .addKey("message").addString(message)
+            .addComma()
+            .addKey("timestamp").addNumber(static_cast<double>(record.timestamp))
+            .endObject();
+        return json.build();
+    }
+
     std::string buildEventJSON(const VMMEvent& event) {
         JSONBuilder json;
         json.startObject()
@@ -331,6 +533,710 @@ private:
     }
 };
 
+// Headless benchmark mode: generates accesses in large batches and
+// feeds them straight into the VMM with no sleeps, no HTTP server, no
+// SSE and no per-access callback dispatch. Used for overnight policy /
+// frame-count sweeps where the interactive pipeline is orders of
+// magnitude too slow.
+namespace bench {
+
+struct BenchOptions {
+    ReplacementPolicy policy = ReplacementPolicy::CLOCK;
+    std::string policy_name = "clock";
+    size_t total_frames = 256;
+    size_t total_pages = 1024;
+    size_t total_requests = 1000000;
+    size_t batch_size = 4096;
+    WorkloadType workload = WorkloadType::RANDOM;
+    std::string workload_name = "random";
+    std::string trace_file;
+    uint64_t seed = 1;        // benchmarks are deterministic by default; 0 = entropy
+    std::string record_file;  // write the access stream as a replayable trace
+    std::string samples_file;  // columnar metric samples (VMRC format)
+    size_t sample_interval_ms = 10;
+    size_t page_table_levels = 1;
+    size_t tlb_entries = 64;
+    SwapDeviceProfile swap_device = SwapDeviceProfile::SSD;
+    std::string swap_device_name = "ssd";
+    size_t fault_cluster_size = 0;
+    size_t numa_nodes = 1;
+    size_t num_address_spaces = 1;
+    bool cow_clone = false;  // fault an image into space 0, COW-clone it into the rest
+    std::vector<WorkloadPhase> phases;
+};
+
+bool parseSwapDevice(const std::string& name, SwapDeviceProfile& device) {
+    if (name == "nvme") { device = SwapDeviceProfile::NVME; return true; }
+    if (name == "ssd") { device = SwapDeviceProfile::SSD; return true; }
+    if (name == "hdd") { device = SwapDeviceProfile::HDD; return true; }
+    return false;
+}
+
+struct BenchResult {
+    std::string policy_name;
+    std::string workload_name;
+    size_t total_frames = 0;
+    size_t total_pages = 0;
+    size_t accesses = 0;
+    double elapsed_s = 0.0;
+    size_t throughput = 0;
+    size_t page_faults = 0;
+    double fault_rate = 0.0;
+    double tlb_hit_rate = 0.0;
+    double simulated_swap_ms = 0.0;
+    size_t swap_max_queue_depth = 0;
+    size_t swap_write_stalls = 0;
+    size_t cluster_prefetches = 0;
+    size_t numa_local_allocations = 0;
+    size_t numa_remote_allocations = 0;
+    size_t cow_breaks = 0;
+    double dedup_ratio = 1.0;
+    double latency_p50_ns = 0.0;
+    double latency_p95_ns = 0.0;
+    double latency_p99_ns = 0.0;
+};
+
+bool parsePolicy(const std::string& name, ReplacementPolicy& policy) {
+    if (name == "fifo") { policy = ReplacementPolicy::FIFO; return true; }
+    if (name == "lru") { policy = ReplacementPolicy::LRU; return true; }
+    if (name == "lru_fast") { policy = ReplacementPolicy::LRU_FAST; return true; }
+    if (name == "clock") { policy = ReplacementPolicy::CLOCK; return true; }
+    if (name == "opt") { policy = ReplacementPolicy::OPT; return true; }
+    if (name == "2q") { policy = ReplacementPolicy::TWO_Q; return true; }
+    if (name == "active") { policy = ReplacementPolicy::ACTIVE_INACTIVE; return true; }
+    return false;
+}
+
+const char* workloadName(WorkloadType type) {
+    switch (type) {
+        case WorkloadType::SEQUENTIAL: return "sequential";
+        case WorkloadType::RANDOM: return "random";
+        case WorkloadType::STRIDED: return "strided";
+        case WorkloadType::ZIPF: return "zipf";
+        case WorkloadType::WEBSERVER: return "webserver";
+        case WorkloadType::TRACE: return "trace";
+    }
+    return "unknown";
+}
+
+bool parseWorkload(const std::string& name, WorkloadType& type) {
+    if (name == "sequential") { type = WorkloadType::SEQUENTIAL; return true; }
+    if (name == "random") { type = WorkloadType::RANDOM; return true; }
+    if (name == "strided") { type = WorkloadType::STRIDED; return true; }
+    if (name == "zipf") { type = WorkloadType::ZIPF; return true; }
+    if (name == "webserver") { type = WorkloadType::WEBSERVER; return true; }
+    if (name == "trace") { type = WorkloadType::TRACE; return true; }
+    return false;
+}
+
+// Strict numeric parsing for flag values: the whole token must convert,
+// so a typo like "--frames 10x" gets the usual usage error instead of
+// an uncaught std::invalid_argument terminating the process.
+bool parseCount(const std::string& value, size_t& out) {
+    try {
+        size_t consumed = 0;
+        unsigned long long parsed = std::stoull(value, &consumed);
+        if (consumed != value.size()) {
+            return false;
+        }
+        out = static_cast<size_t>(parsed);
+        return true;
+    } catch (const std::exception&) {
+        return false;
+    }
+}
+
+// Phase spec: comma-separated "type:duration" pairs, e.g.
+// "zipf:200000,sequential:100000,random:50000". Pattern parameters use
+// the workload defaults; richer programs go through WorkloadConfig
+// directly.
+bool parsePhaseSpec(const std::string& spec, std::vector<WorkloadPhase>& phases) {
+    std::stringstream stream(spec);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        size_t colon = item.find(':');
+        if (colon == std::string::npos) {
+            return false;
+        }
+        WorkloadPhase phase;
+        if (!parseWorkload(item.substr(0, colon), phase.type)) {
+            return false;
+        }
+        if (!parseCount(item.substr(colon + 1), phase.duration) ||
+            phase.duration == 0) {
+            return false;
+        }
+        phases.push_back(phase);
+    }
+    return !phases.empty();
+}
+
+bool parseOptions(int argc, char* argv[], BenchOptions& options) {
+    for (int i = 2; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto nextValue = [&](std::string& out) {
+            if (i + 1 >= argc) return false;
+            out = argv[++i];
+            return true;
+        };
+        std::string value;
+        // Numeric flags share one error path so a malformed value is
+        // reported against the flag it was given for
+        auto numberValue = [&](size_t& out) {
+            if (!parseCount(value, out)) {
+                std::cerr << "Bad number for " << arg << ": " << value << std::endl;
+                return false;
+            }
+            return true;
+        };
+        if (arg == "--policy" && nextValue(value)) {
+            if (!parsePolicy(value, options.policy)) {
+                std::cerr << "Unknown policy: " << value << std::endl;
+                return false;
+            }
+            options.policy_name = value;
+        } else if (arg == "--frames" && nextValue(value)) {
+            if (!numberValue(options.total_frames)) return false;
+        } else if (arg == "--pages" && nextValue(value)) {
+            if (!numberValue(options.total_pages)) return false;
+        } else if (arg == "--requests" && nextValue(value)) {
+            if (!numberValue(options.total_requests)) return false;
+        } else if (arg == "--batch" && nextValue(value)) {
+            if (!numberValue(options.batch_size)) return false;
+        } else if (arg == "--workload" && nextValue(value)) {
+            if (!parseWorkload(value, options.workload)) {
+                std::cerr << "Unknown workload: " << value << std::endl;
+                return false;
+            }
+            options.workload_name = value;
+        } else if (arg == "--trace" && nextValue(value)) {
+            options.trace_file = value;
+            options.workload = WorkloadType::TRACE;
+            options.workload_name = "trace";
+        } else if (arg == "--seed" && nextValue(value)) {
+            size_t seed_value = 0;
+            if (!numberValue(seed_value)) return false;
+            options.seed = seed_value;
+        } else if (arg == "--record" && nextValue(value)) {
+            options.record_file = value;
+        } else if (arg == "--samples" && nextValue(value)) {
+            options.samples_file = value;
+        } else if (arg == "--sample-interval" && nextValue(value)) {
+            if (!numberValue(options.sample_interval_ms)) return false;
+        } else if (arg == "--levels" && nextValue(value)) {
+            if (!numberValue(options.page_table_levels)) return false;
+        } else if (arg == "--tlb" && nextValue(value)) {
+            if (!numberValue(options.tlb_entries)) return false;
+        } else if (arg == "--swap" && nextValue(value)) {
+            if (!parseSwapDevice(value, options.swap_device)) {
+                std::cerr << "Unknown swap device: " << value << std::endl;
+                return false;
+            }
+            options.swap_device_name = value;
+        } else if (arg == "--cluster" && nextValue(value)) {
+            if (!numberValue(options.fault_cluster_size)) return false;
+        } else if (arg == "--numa" && nextValue(value)) {
+            if (!numberValue(options.numa_nodes)) return false;
+        } else if (arg == "--spaces" && nextValue(value)) {
+            if (!numberValue(options.num_address_spaces)) return false;
+        } else if (arg == "--cow") {
+            options.cow_clone = true;
+        } else if (arg == "--phases" && nextValue(value)) {
+            if (!parsePhaseSpec(value, options.phases)) {
+                std::cerr << "Bad phase spec: " << value << std::endl;
+                return false;
+            }
+            options.workload_name = "phased";
+        } else {
+            std::cerr << "Unknown benchmark option: " << arg << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+// Runs one policy/workload/frame-count combination to completion and
+// returns its numbers without printing; shared by --bench and --sweep.
+BenchResult runOne(const BenchOptions& options) {
+    VMMConfig vmm_config;
+    vmm_config.total_frames = options.total_frames;
+    vmm_config.total_pages = options.total_pages;
+    vmm_config.replacement_policy = options.policy;
+    vmm_config.enable_ai_predictions = false;
+    // Nothing drains the ring in benchmark mode; sample aggressively so
+    // pushes are rare and cheap
+    vmm_config.access_event_sample_interval = 1 << 20;
+    vmm_config.logical_timestamps = true;
+    vmm_config.access_log_file = options.record_file;
+    vmm_config.page_table_levels = options.page_table_levels;
+    vmm_config.tlb_entries = options.tlb_entries;
+    vmm_config.swap_device = options.swap_device;
+    vmm_config.fault_cluster_size = options.fault_cluster_size;
+    vmm_config.numa_nodes = options.numa_nodes;
+    vmm_config.num_address_spaces = options.num_address_spaces;
+    vmm_config.frame_pool_shards = std::max<size_t>(options.numa_nodes * 2, 4);
+
+    WorkloadConfig workload_config;
+    workload_config.type = options.workload;
+    workload_config.total_requests = options.total_requests;
+    workload_config.page_range = options.total_pages;
+    workload_config.trace_file = options.trace_file;
+    workload_config.seed = options.seed;
+    workload_config.phases = options.phases;
+
+    VMM vmm(vmm_config);
+    WorkloadGenerator generator(workload_config);
+
+    // Phase-boundary markers: printed with the fault count at the
+    // boundary so recovery cost after a transition is measurable
+    if (!options.phases.empty()) {
+        generator.setPhaseCallback([&vmm](size_t index, const WorkloadPhase& phase) {
+            std::cout << "phase " << index << " entered (" << workloadName(phase.type)
+                      << ", " << phase.duration << " accesses)"
+                      << ", faults so far " << vmm.getPageFaults() << std::endl;
+        });
+    }
+
+    // OPT is an offline policy: it needs the whole access stream up
+    // front, so pre-generate it and replay from the buffer instead of
+    // streaming from the generator
+    std::vector<int> future_pages;
+    std::vector<bool> future_writes;
+    if (options.policy == ReplacementPolicy::OPT) {
+        future_pages.reserve(options.total_requests);
+        future_writes.reserve(options.total_requests);
+        while (future_pages.size() < options.total_requests) {
+            size_t chunk = std::min(options.total_requests - future_pages.size(),
+                                    options.batch_size);
+            std::vector<bool> chunk_writes;
+            std::vector<int> pages = generator.generateBatch(chunk, chunk_writes);
+            if (pages.empty()) {
+                break; // trace exhausted
+            }
+            future_pages.insert(future_pages.end(), pages.begin(), pages.end());
+            future_writes.insert(future_writes.end(), chunk_writes.begin(),
+                                 chunk_writes.end());
+        }
+        vmm.setFutureTrace(future_pages);
+    }
+
+    // Optional run-recorder: samples the metric counters into a
+    // columnar binary file from its own thread (see RunRecorder.h)
+    std::unique_ptr<RunRecorder> recorder;
+    if (!options.samples_file.empty()) {
+        recorder = std::make_unique<RunRecorder>(vmm, options.samples_file,
+                                                 options.sample_interval_ms);
+        recorder->start();
+    }
+
+    vmm.startSimulation();
+
+    // Tenant-density mode: fault a shared image into space 0, then
+    // COW-clone it into every other space before the measured run, so
+    // N similar tenants start out backed by one set of frames
+    if (options.cow_clone && vmm.getAddressSpaceCount() > 1) {
+        std::vector<PageAccess> image;
+        size_t image_pages = std::min(options.total_frames, options.total_pages);
+        image.reserve(image_pages);
+        for (size_t p = 0; p < image_pages; ++p) {
+            image.emplace_back(static_cast<int>(p), false);
+        }
+        vmm.accessBatch(0, image);
+        for (size_t s = 1; s < vmm.getAddressSpaceCount(); ++s) {
+            vmm.cloneAddressSpace(0, static_cast<int>(s));
+        }
+    }
+
+    std::vector<PageAccess> batch;
+    batch.reserve(options.batch_size);
+    std::vector<double> batch_latencies_ns;
+    batch_latencies_ns.reserve(options.total_requests / options.batch_size + 1);
+
+    size_t remaining = options.policy == ReplacementPolicy::OPT
+        ? future_pages.size() : options.total_requests;
+    size_t replay_pos = 0;
+    // Round-robin batches across address spaces so --spaces exercises
+    // the per-space tables and the NUMA-partitioned allocator
+    size_t batch_counter = 0;
+    auto run_start = std::chrono::steady_clock::now();
+
+    while (remaining > 0) {
+        size_t chunk = std::min(remaining, options.batch_size);
+        std::vector<int> pages;
+        std::vector<bool> write_mask;
+        if (options.policy == ReplacementPolicy::OPT) {
+            pages.assign(future_pages.begin() + replay_pos,
+                         future_pages.begin() + replay_pos + chunk);
+            write_mask.assign(future_writes.begin() + replay_pos,
+                              future_writes.begin() + replay_pos + chunk);
+            replay_pos += chunk;
+        } else {
+            pages = generator.generateBatch(chunk, write_mask);
+        }
+        if (pages.empty()) {
+            break; // trace exhausted
+        }
+
+        batch.clear();
+        for (size_t i = 0; i < pages.size(); ++i) {
+            // Trace replays keep the recorded write bit; COW mode mixes in
+            // writes (1 in 4) so shared mappings actually break — pure-read
+            // runs would never copy
+            bool is_write = write_mask[i] || (options.cow_clone && (i & 3) == 0);
+            batch.emplace_back(pages[i], is_write);
+        }
+
+        int space = static_cast<int>(batch_counter++ % vmm.getAddressSpaceCount());
+
+        auto batch_start = std::chrono::steady_clock::now();
+        vmm.accessBatch(space, batch);
+        auto batch_end = std::chrono::steady_clock::now();
+
+        double ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            batch_end - batch_start).count();
+        batch_latencies_ns.push_back(ns / batch.size());
+
+        remaining -= pages.size();
+    }
+
+    auto run_end = std::chrono::steady_clock::now();
+    double elapsed_s = std::chrono::duration_cast<std::chrono::microseconds>(
+        run_end - run_start).count() / 1e6;
+
+    vmm.stopSimulation();
+    if (recorder) {
+        recorder->stop();
+    }
+
+    size_t accesses = vmm.getTotalAccesses();
+    std::sort(batch_latencies_ns.begin(), batch_latencies_ns.end());
+    auto percentile = [&](double p) {
+        if (batch_latencies_ns.empty()) return 0.0;
+        size_t index = static_cast<size_t>(p * (batch_latencies_ns.size() - 1));
+        return batch_latencies_ns[index];
+    };
+
+    BenchResult result;
+    result.policy_name = options.policy_name;
+    result.workload_name = generator.getWorkloadDescription();
+    result.total_frames = options.total_frames;
+    result.total_pages = options.total_pages;
+    result.accesses = accesses;
+    result.elapsed_s = elapsed_s;
+    result.throughput = static_cast<size_t>(accesses / (elapsed_s > 0 ? elapsed_s : 1));
+    result.page_faults = vmm.getPageFaults();
+    result.fault_rate = vmm.getPageFaultRate();
+    result.tlb_hit_rate = vmm.getMetricsSnapshot().tlb_hit_rate;
+    SwapMetricsSnapshot swap = vmm.getSwapMetricsSnapshot();
+    result.simulated_swap_ms = swap.simulated_total_ms;
+    result.swap_max_queue_depth = swap.max_queue_depth;
+    result.swap_write_stalls = swap.write_stalls;
+    result.cluster_prefetches = vmm.getMetricsSnapshot().cluster_prefetches;
+    result.numa_local_allocations = vmm.getMetricsSnapshot().numa_local_allocations;
+    result.numa_remote_allocations = vmm.getMetricsSnapshot().numa_remote_allocations;
+    result.cow_breaks = vmm.getMetricsSnapshot().cow_breaks;
+    result.dedup_ratio = vmm.getMetricsSnapshot().dedup_ratio;
+    result.latency_p50_ns = percentile(0.50);
+    result.latency_p95_ns = percentile(0.95);
+    result.latency_p99_ns = percentile(0.99);
+    return result;
+}
+
+int run(int argc, char* argv[]) {
+    BenchOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        std::cerr << "Usage: vmm_simulator --bench [--policy fifo|lru|lru_fast|clock|opt|2q|active]\n"
+                  << "                     [--frames N] [--pages N] [--requests N]\n"
+                  << "                     [--batch N] [--workload TYPE] [--trace FILE]\n"
+                  << "                     [--seed N] [--record FILE] [--levels N] [--tlb N]\n"
+                  << "                     [--swap nvme|ssd|hdd] [--cluster N]\n"
+                  << "                     [--numa N] [--spaces N] [--cow]\n"
+                  << "                     [--samples FILE] [--sample-interval MS]"
+                  << std::endl;
+        return 1;
+    }
+
+    BenchResult result = runOne(options);
+
+    std::cout << "Benchmark results" << std::endl;
+    std::cout << "=================" << std::endl;
+    std::cout << "policy:           " << result.policy_name << std::endl;
+    std::cout << "workload:         " << result.workload_name << std::endl;
+    std::cout << "frames:           " << result.total_frames << std::endl;
+    std::cout << "pages:            " << result.total_pages << std::endl;
+    std::cout << "accesses:         " << result.accesses << std::endl;
+    std::cout << "elapsed:          " << result.elapsed_s << " s" << std::endl;
+    std::cout << "throughput:       " << result.throughput << " accesses/s" << std::endl;
+    std::cout << "page_faults:      " << result.page_faults << std::endl;
+    std::cout << "fault_rate:       " << result.fault_rate << std::endl;
+    std::cout << "tlb_hit_rate:     " << result.tlb_hit_rate << std::endl;
+    std::cout << "swap_device:      " << options.swap_device_name << std::endl;
+    std::cout << "simulated_swap:   " << result.simulated_swap_ms << " ms" << std::endl;
+    std::cout << "swap_queue_max:   " << result.swap_max_queue_depth << std::endl;
+    std::cout << "swap_stalls:      " << result.swap_write_stalls << std::endl;
+    std::cout << "cluster_prefetch: " << result.cluster_prefetches << std::endl;
+    std::cout << "numa_local:       " << result.numa_local_allocations << std::endl;
+    std::cout << "numa_remote:      " << result.numa_remote_allocations << std::endl;
+    std::cout << "cow_breaks:       " << result.cow_breaks << std::endl;
+    std::cout << "dedup_ratio:      " << result.dedup_ratio << std::endl;
+    std::cout << "latency_p50:      " << result.latency_p50_ns << " ns/access" << std::endl;
+    std::cout << "latency_p95:      " << result.latency_p95_ns << " ns/access" << std::endl;
+    std::cout << "latency_p99:      " << result.latency_p99_ns << " ns/access" << std::endl;
+
+    return 0;
+}
+
+} // namespace bench
+
+// Parallel sweep mode (--sweep matrix.json): expands a JSON config
+// matrix (policies x frame counts x workloads) into independent
+// benchmark jobs and runs them across a thread pool, one VMM +
+// WorkloadGenerator pair per job. Instances share nothing, so this
+// scales nearly linearly with cores. Results come out as one CSV table
+// (and optionally JSON) instead of 120 serial --bench invocations.
+namespace sweep {
+
+struct SweepOptions {
+    std::string matrix_file;
+    std::string output_file;   // empty = stdout
+    bool json_output = false;
+    size_t threads = 0;        // 0 = one per core
+};
+
+// Minimal extractors for the matrix file, in the same spirit as the
+// server's request parsing: scan for "key": and read either a scalar
+// or a [...] list. Good enough for hand-written config files.
+std::vector<std::string> parseStringList(const std::string& json, const std::string& key) {
+    std::vector<std::string> values;
+    size_t pos = json.find("\"" + key + "\"");
+    if (pos == std::string::npos) {
+        return values;
+    }
+    pos = json.find(':', pos);
+    if (pos == std::string::npos) {
+        return values;
+    }
+    pos++;
+    while (pos < json.length() && (json[pos] == ' ' || json[pos] == '\t' || json[pos] == '\n')) {
+        pos++;
+    }
+    size_t end = pos;
+    if (json[pos] == '[') {
+        end = json.find(']', pos);
+        if (end == std::string::npos) {
+            return values;
+        }
+        pos++;
+    } else {
+        end = json.find_first_of(",}\n", pos);
+    }
+    // Split the span on commas, trimming whitespace and quotes
+    std::string span = json.substr(pos, end - pos);
+    std::string current;
+    for (char c : span) {
+        if (c == ',') {
+            if (!current.empty()) {
+                values.push_back(current);
+            }
+            current.clear();
+        } else if (c != ' ' && c != '\t' && c != '\n' && c != '"') {
+            current += c;
+        }
+    }
+    if (!current.empty()) {
+        values.push_back(current);
+    }
+    return values;
+}
+
+std::vector<size_t> parseNumberList(const std::string& json, const std::string& key) {
+    std::vector<size_t> values;
+    for (const auto& token : parseStringList(json, key)) {
+        size_t value = 0;
+        if (bench::parseCount(token, value)) {
+            values.push_back(value);
+        }
+        // malformed entries are skipped
+    }
+    return values;
+}
+
+bool buildJobs(const std::string& matrix_file, std::vector<bench::BenchOptions>& jobs) {
+    std::ifstream file(matrix_file);
+    if (!file.is_open()) {
+        std::cerr << "Cannot open matrix file: " << matrix_file << std::endl;
+        return false;
+    }
+    std::string json((std::istreambuf_iterator<char>(file)),
+                     std::istreambuf_iterator<char>());
+
+    std::vector<std::string> policies = parseStringList(json, "policies");
+    std::vector<std::string> workloads = parseStringList(json, "workloads");
+    std::vector<size_t> frames = parseNumberList(json, "frames");
+    std::vector<size_t> pages = parseNumberList(json, "pages");
+    std::vector<size_t> requests = parseNumberList(json, "requests");
+
+    // Scalar dimensions default so a matrix only needs the axes it sweeps
+    if (policies.empty()) policies = {"clock"};
+    if (workloads.empty()) workloads = {"random"};
+    if (frames.empty()) frames = {256};
+    if (pages.empty()) pages = {1024};
+    if (requests.empty()) requests = {1000000};
+
+    for (const auto& policy_name : policies) {
+        for (const auto& workload_name : workloads) {
+            for (size_t frame_count : frames) {
+                for (size_t page_count : pages) {
+                    for (size_t request_count : requests) {
+                        bench::BenchOptions options;
+                        if (!bench::parsePolicy(policy_name, options.policy)) {
+                            std::cerr << "Unknown policy in matrix: " << policy_name << std::endl;
+                            return false;
+                        }
+                        if (!bench::parseWorkload(workload_name, options.workload)) {
+                            std::cerr << "Unknown workload in matrix: " << workload_name << std::endl;
+                            return false;
+                        }
+                        options.policy_name = policy_name;
+                        options.workload_name = workload_name;
+                        options.total_frames = frame_count;
+                        options.total_pages = page_count;
+                        options.total_requests = request_count;
+                        jobs.push_back(options);
+                    }
+                }
+            }
+        }
+    }
+    return true;
+}
+
+std::string buildCSV(const std::vector<bench::BenchResult>& results) {
+    std::ostringstream csv;
+    csv << "policy,workload,frames,pages,accesses,elapsed_s,throughput,"
+        << "page_faults,fault_rate,tlb_hit_rate,simulated_swap_ms,"
+        << "latency_p50_ns,latency_p95_ns,latency_p99_ns\n";
+    for (const auto& r : results) {
+        csv << r.policy_name << ',' << r.workload_name << ',' << r.total_frames << ','
+            << r.total_pages << ',' << r.accesses << ',' << r.elapsed_s << ','
+            << r.throughput << ',' << r.page_faults << ',' << r.fault_rate << ','
+            << r.tlb_hit_rate << ',' << r.simulated_swap_ms << ','
+            << r.latency_p50_ns << ',' << r.latency_p95_ns << ',' << r.latency_p99_ns << '\n';
+    }
+    return csv.str();
+}
+
+std::string buildJSON(const std::vector<bench::BenchResult>& results) {
+    api::JSONBuilder json;
+    json.startObject().addKey("results").startArray();
+    for (size_t i = 0; i < results.size(); ++i) {
+        const auto& r = results[i];
+        if (i > 0) {
+            json.addComma();
+        }
+        json.startObject()
+            .addKey("policy").addString(r.policy_name).addComma()
+            .addKey("workload").addString(r.workload_name).addComma()
+            .addKey("frames").addNumber(r.total_frames).addComma()
+            .addKey("pages").addNumber(r.total_pages).addComma()
+            .addKey("accesses").addNumber(r.accesses).addComma()
+            .addKey("elapsed_s").addNumber(r.elapsed_s).addComma()
+            .addKey("throughput").addNumber(r.throughput).addComma()
+            .addKey("page_faults").addNumber(r.page_faults).addComma()
+            .addKey("fault_rate").addNumber(r.fault_rate).addComma()
+            .addKey("tlb_hit_rate").addNumber(r.tlb_hit_rate).addComma()
+            .addKey("simulated_swap_ms").addNumber(r.simulated_swap_ms).addComma()
+            .addKey("latency_p50_ns").addNumber(r.latency_p50_ns).addComma()
+            .addKey("latency_p95_ns").addNumber(r.latency_p95_ns).addComma()
+            .addKey("latency_p99_ns").addNumber(r.latency_p99_ns)
+            .endObject();
+    }
+    json.endArray().endObject();
+    return json.build();
+}
+
+int run(int argc, char* argv[]) {
+    SweepOptions options;
+    for (int i = 2; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--out" && i + 1 < argc) {
+            options.output_file = argv[++i];
+        } else if (arg == "--json") {
+            options.json_output = true;
+        } else if (arg == "--threads" && i + 1 < argc) {
+            if (!bench::parseCount(argv[++i], options.threads)) {
+                std::cerr << "Bad number for --threads: " << argv[i] << std::endl;
+                return 1;
+            }
+        } else if (options.matrix_file.empty()) {
+            options.matrix_file = arg;
+        } else {
+            std::cerr << "Unknown sweep option: " << arg << std::endl;
+            return 1;
+        }
+    }
+    if (options.matrix_file.empty()) {
+        std::cerr << "Usage: vmm_simulator --sweep matrix.json [--threads N] [--out FILE] [--json]"
+                  << std::endl;
+        return 1;
+    }
+
+    std::vector<bench::BenchOptions> jobs;
+    if (!buildJobs(options.matrix_file, jobs)) {
+        return 1;
+    }
+
+    size_t num_threads = options.threads > 0 ? options.threads
+        : std::max<size_t>(1, std::thread::hardware_concurrency());
+    num_threads = std::min(num_threads, jobs.size());
+
+    std::cerr << "Sweep: " << jobs.size() << " configurations on "
+              << num_threads << " threads" << std::endl;
+
+    // Results are pre-sized so workers write disjoint slots and need no
+    // lock; the atomic counter hands out jobs as threads free up
+    std::vector<bench::BenchResult> results(jobs.size());
+    std::atomic<size_t> next_job{0};
+    auto run_start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < num_threads; ++t) {
+        workers.emplace_back([&]() {
+            while (true) {
+                size_t index = next_job.fetch_add(1);
+                if (index >= jobs.size()) {
+                    break;
+                }
+                results[index] = bench::runOne(jobs[index]);
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    auto run_end = std::chrono::steady_clock::now();
+    double elapsed_s = std::chrono::duration_cast<std::chrono::milliseconds>(
+        run_end - run_start).count() / 1e3;
+    std::cerr << "Sweep finished in " << elapsed_s << " s" << std::endl;
+
+    std::string table = options.json_output ? buildJSON(results) : buildCSV(results);
+    if (options.output_file.empty()) {
+        std::cout << table;
+    } else {
+        std::ofstream out(options.output_file);
+        if (!out.is_open()) {
+            std::cerr << "Cannot write output file: " << options.output_file << std::endl;
+            return 1;
+        }
+        out << table;
+        std::cerr << "Results written to " << options.output_file << std::endl;
+    }
+    return 0;
+}
+
+} // namespace sweep
+
 // Global simulator instance for signal handling
 std::unique_ptr<VMMSimulator> g_simulator;
 
@@ -342,7 +1248,15 @@ void signalHandler(int signal) {
     exit(0);
 }
 
-int main() {
+int main(int argc, char* argv[]) {
+    // Headless benchmark mode bypasses the server/SSE pipeline entirely
+    if (argc > 1 && std::string(argv[1]) == "--bench") {
+        return bench::run(argc, argv);
+    }
+    if (argc > 1 && std::string(argv[1]) == "--sweep") {
+        return sweep::run(argc, argv);
+    }
+
     std::cout << "Virtual Memory Manager Simulator" << std::endl;
     std::cout << "=================================" << std::endl;
     
@@ -350,8 +1264,18 @@ int main() {
     signal(SIGINT, signalHandler);
     signal(SIGTERM, signalHandler);
     
+    // Optional shared-memory predictor channel: the sidecar maps the
+    // same segment and exchanges access history / predictions with no
+    // HTTP round trips (see PredictorChannel.h for the layout)
+    std::string predictor_shm;
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (std::string(argv[i]) == "--predictor-shm") {
+            predictor_shm = argv[i + 1];
+        }
+    }
+
     try {
-        g_simulator = std::make_unique<VMMSimulator>();
+        g_simulator = std::make_unique<VMMSimulator>(predictor_shm);
         g_simulator->start();
         
         std::cout << "\nServer is running. Press Ctrl+C to stop." << std::endl;
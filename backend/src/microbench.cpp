@@ -0,0 +1,453 @@
+// vmm_bench: micro-benchmarks for the VMM primitives.
+//
+// Where `vmm_simulator --bench` measures end-to-end throughput, this
+// tool times individual primitives in isolation — page-table lookup,
+// fault handling, victim selection per policy and frame count, workload
+// generation per type, JSON building — so a change that slows one of
+// them shows up immediately instead of weeks later as an unexplained
+// dip in end-to-end numbers.
+//
+// Each benchmark runs a warm-up pass, then several timed repetitions;
+// the fastest repetition is reported as ns/op and cycles/op (cycle
+// counts via rdtsc on x86, the virtual counter on aarch64). With
+// --save-baseline the results are written to a text file; a later run
+// with --baseline compares against it and flags any benchmark slower
+// than the threshold (default 10%), exiting nonzero so CI can gate on
+// it.
+//
+// Usage:
+//   vmm_bench [--filter SUBSTR] [--reps N]
+//             [--save-baseline FILE] [--baseline FILE] [--threshold PCT]
+
+#include "vmm/VMM.h"
+#include "vmm/PageTable.h"
+#include "vmm/FrameTable.h"
+#include "vmm/Replacement.h"
+#include "workload/WorkloadGen.h"
+#include "api/Server.h"
+
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+using namespace vmm;
+using namespace workload;
+
+namespace microbench {
+
+// Results funnel into a volatile sink so the compiler cannot elide the
+// measured work
+volatile uint64_t g_sink = 0;
+
+uint64_t readCycles() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#elif defined(__aarch64__)
+    uint64_t value;
+    asm volatile("mrs %0, cntvct_el0" : "=r"(value));
+    return value;
+#else
+    return 0;
+#endif
+}
+
+struct Options {
+    std::string filter;
+    size_t reps = 5;
+    std::string baseline_in;
+    std::string baseline_out;
+    double threshold = 0.10;  // flag regressions beyond +10%
+};
+
+struct Result {
+    std::string name;
+    size_t iters = 0;
+    double ns_per_op = 0.0;
+    double cycles_per_op = 0.0;
+};
+
+bool matchesFilter(const Options& options, const std::string& name) {
+    return options.filter.empty() || name.find(options.filter) != std::string::npos;
+}
+
+// Runs `op(i)` for `iters` iterations: one warm-up pass, then
+// `reps` timed repetitions, keeping the fastest (least-disturbed) one.
+template <typename F>
+Result runBenchmark(const std::string& name, size_t iters, size_t reps, F&& op) {
+    for (size_t i = 0; i < iters / 4 + 1; ++i) {
+        op(i);
+    }
+
+    double best_ns = 0.0;
+    double best_cycles = 0.0;
+    for (size_t rep = 0; rep < reps; ++rep) {
+        uint64_t c0 = readCycles();
+        auto t0 = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < iters; ++i) {
+            op(i);
+        }
+        auto t1 = std::chrono::steady_clock::now();
+        uint64_t c1 = readCycles();
+
+        double ns = std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count()
+                    / static_cast<double>(iters);
+        double cycles = static_cast<double>(c1 - c0) / static_cast<double>(iters);
+        if (rep == 0 || ns < best_ns) {
+            best_ns = ns;
+            best_cycles = cycles;
+        }
+    }
+
+    Result result;
+    result.name = name;
+    result.iters = iters;
+    result.ns_per_op = best_ns;
+    result.cycles_per_op = best_cycles;
+    return result;
+}
+
+// ---------------------------------------------------------------------------
+// Individual benchmarks. Each registers under a path-style name so
+// --filter can select groups (e.g. --filter replacement/).
+// ---------------------------------------------------------------------------
+
+void benchPageTableLookup(std::vector<Result>& results, const Options& options) {
+    struct Variant { const char* name; size_t levels; };
+    const Variant variants[] = {
+        {"page_table/lookup/flat", 1},
+        {"page_table/lookup/radix3", 3},
+    };
+    constexpr size_t PAGES = 65536;
+
+    for (const Variant& variant : variants) {
+        if (!matchesFilter(options, variant.name)) {
+            continue;
+        }
+        PageTable table(4096, PAGES, /*dense_storage=*/variant.levels == 1,
+                        variant.levels);
+        for (int page = 0; page < static_cast<int>(PAGES); page += 2) {
+            table.setPageValid(page, true);
+            table.setFrameNumber(page, page % 256);
+        }
+        // Multiplicative hash over the page range: cheap, deterministic,
+        // defeats the prefetcher without dominating the measurement
+        results.push_back(runBenchmark(variant.name, 1000000, options.reps, [&](size_t i) {
+            int page = static_cast<int>((i * 2654435761u) % PAGES);
+            g_sink += table.isPageValid(page) ? table.getFrameNumber(page) : 0;
+        }));
+    }
+}
+
+void benchFaultHandling(std::vector<Result>& results, const Options& options) {
+    VMMConfig config;
+    config.total_frames = 128;
+    config.total_pages = 65536;
+    config.enable_ai_predictions = false;
+    config.instrumentation_sample_interval = 0;
+    config.access_event_sample_interval = 1024;
+    config.logical_timestamps = true;
+
+    // Every access in a sequential sweep wider than the frame pool
+    // faults: claim, evict, swap accounting, page-table update
+    if (matchesFilter(options, "vmm/fault")) {
+        VMM vmm(config);
+        vmm.startSimulation();
+        results.push_back(runBenchmark("vmm/fault", 200000, options.reps, [&](size_t i) {
+            g_sink += vmm.accessPage(static_cast<int>(i % config.total_pages)) ? 1 : 0;
+        }));
+        vmm.stopSimulation();
+    }
+
+    // Resident working set: the no-fault hot path (TLB + page table +
+    // replacement bookkeeping) for comparison
+    if (matchesFilter(options, "vmm/hit")) {
+        VMM vmm(config);
+        vmm.startSimulation();
+        results.push_back(runBenchmark("vmm/hit", 1000000, options.reps, [&](size_t i) {
+            g_sink += vmm.accessPage(static_cast<int>(i % 64)) ? 1 : 0;
+        }));
+        vmm.stopSimulation();
+    }
+}
+
+void benchVictimSelection(std::vector<Result>& results, const Options& options) {
+    const ReplacementPolicy policies[] = {
+        ReplacementPolicy::FIFO,    ReplacementPolicy::LRU,
+        ReplacementPolicy::LRU_FAST, ReplacementPolicy::CLOCK,
+        ReplacementPolicy::OPT,     ReplacementPolicy::TWO_Q,
+        ReplacementPolicy::ACTIVE_INACTIVE,
+    };
+    const char* policy_names[] = {"fifo", "lru", "lru_fast", "clock", "opt", "2q", "active"};
+    const size_t frame_counts[] = {64, 512, 4096};
+    constexpr size_t ITERS = 200000;
+
+    for (size_t p = 0; p < sizeof(policies) / sizeof(policies[0]); ++p) {
+        for (size_t frames : frame_counts) {
+            std::ostringstream name;
+            name << "replacement/" << policy_names[p] << "/" << frames;
+            if (!matchesFilter(options, name.str())) {
+                continue;
+            }
+            ReplacementManager manager(policies[p], frames);
+            FrameTable table(frames);
+            size_t page_range = frames * 4;
+
+            // OPT victim selection walks per-page use lists built from
+            // the future trace; feed it the same stream it will consume
+            std::vector<int> trace(ITERS + frames);
+            for (size_t i = 0; i < trace.size(); ++i) {
+                trace[i] = static_cast<int>((i * 2654435761u) % page_range);
+            }
+            manager.setFutureTrace(trace);
+
+            size_t clock = 0;
+            size_t trace_pos = 0;
+            for (size_t f = 0; f < frames; ++f) {
+                int page = trace[trace_pos++];
+                table.assign(static_cast<int>(f), 0, page);
+                table.recordAccess(static_cast<int>(f), clock++);
+                manager.recordPagePlacement(static_cast<int>(f), page);
+                manager.recordFrameAccess(static_cast<int>(f));
+            }
+
+            results.push_back(runBenchmark(name.str(), ITERS, options.reps, [&](size_t) {
+                int page = trace[trace_pos % trace.size()];
+                trace_pos++;
+                manager.recordPageAccess(page);
+                int victim = manager.selectVictimFrame(table);
+                manager.recordFrameEviction(victim);
+                table.release(victim);
+                table.assign(victim, 0, page);
+                table.recordAccess(victim, clock++);
+                manager.recordPagePlacement(victim, page);
+                manager.recordFrameAccess(victim);
+                g_sink += static_cast<uint64_t>(victim);
+            }));
+        }
+    }
+}
+
+void benchWorkloadGeneration(std::vector<Result>& results, const Options& options) {
+    const WorkloadType types[] = {
+        WorkloadType::SEQUENTIAL, WorkloadType::RANDOM, WorkloadType::STRIDED,
+        WorkloadType::ZIPF,       WorkloadType::WEBSERVER,
+    };
+    const char* type_names[] = {"sequential", "random", "strided", "zipf", "webserver"};
+
+    for (size_t t = 0; t < sizeof(types) / sizeof(types[0]); ++t) {
+        std::ostringstream name;
+        name << "workload/" << type_names[t];
+        if (!matchesFilter(options, name.str())) {
+            continue;
+        }
+        WorkloadConfig config;
+        config.type = types[t];
+        config.page_range = 65536;
+        config.total_requests = 1u << 30;  // never complete during the bench
+        config.seed = 1;
+        WorkloadGenerator generator(config);
+
+        WorkloadType type = types[t];
+        results.push_back(runBenchmark(name.str(), 1000000, options.reps, [&](size_t) {
+            switch (type) {
+                case WorkloadType::SEQUENTIAL:
+                    g_sink += generator.generateSequentialAccess(); break;
+                case WorkloadType::RANDOM:
+                    g_sink += generator.generateRandomAccess(); break;
+                case WorkloadType::STRIDED:
+                    g_sink += generator.generateStridedAccess(); break;
+                case WorkloadType::ZIPF:
+                    g_sink += generator.generateZipfAccess(); break;
+                default:
+                    g_sink += generator.generateWebserverAccess(); break;
+            }
+        }));
+    }
+}
+
+void benchJSONBuilding(std::vector<Result>& results, const Options& options) {
+    if (!matchesFilter(options, "json/metrics")) {
+        return;
+    }
+    // Mirrors the /metrics response shape: the JSON rebuilt on every
+    // cache-miss poll
+    results.push_back(runBenchmark("json/metrics", 200000, options.reps, [&](size_t i) {
+        api::JSONBuilder builder;
+        builder.startObject()
+            .addKey("total_accesses").addNumber(static_cast<double>(i)).addComma()
+            .addKey("page_faults").addNumber(static_cast<double>(i / 8)).addComma()
+            .addKey("page_fault_rate").addNumber(0.125).addComma()
+            .addKey("swap_ins").addNumber(42).addComma()
+            .addKey("swap_outs").addNumber(17).addComma()
+            .addKey("tlb_hits").addNumber(static_cast<double>(i)).addComma()
+            .addKey("tlb_misses").addNumber(static_cast<double>(i / 16)).addComma()
+            .addKey("tlb_hit_rate").addNumber(0.9375).addComma()
+            .addKey("running").addBoolean(true)
+            .endObject();
+        g_sink += builder.build().size();
+    }));
+}
+
+// ---------------------------------------------------------------------------
+// Baseline files: one "name ns_per_op" line per benchmark
+// ---------------------------------------------------------------------------
+
+bool loadBaseline(const std::string& path, std::map<std::string, double>& baseline) {
+    std::ifstream in(path);
+    if (!in) {
+        return false;
+    }
+    std::string name;
+    double ns = 0.0;
+    while (in >> name >> ns) {
+        baseline[name] = ns;
+    }
+    return true;
+}
+
+bool saveBaseline(const std::string& path, const std::vector<Result>& results) {
+    std::ofstream out(path);
+    if (!out) {
+        return false;
+    }
+    for (const Result& result : results) {
+        out << result.name << " " << result.ns_per_op << "\n";
+    }
+    return true;
+}
+
+bool parseOptions(int argc, char* argv[], Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto nextValue = [&](std::string& out) {
+            if (i + 1 >= argc) return false;
+            out = argv[++i];
+            return true;
+        };
+        // Strict conversions: the whole token must be numeric, so a typo
+        // gets a usage error instead of an uncaught std::invalid_argument
+        auto parseReps = [](const std::string& token, size_t& out) {
+            try {
+                size_t consumed = 0;
+                out = std::stoul(token, &consumed);
+                return consumed == token.size();
+            } catch (const std::exception&) {
+                return false;
+            }
+        };
+        auto parsePercent = [](const std::string& token, double& out) {
+            try {
+                size_t consumed = 0;
+                out = std::stod(token, &consumed);
+                return consumed == token.size();
+            } catch (const std::exception&) {
+                return false;
+            }
+        };
+        std::string value;
+        if (arg == "--filter" && nextValue(value)) {
+            options.filter = value;
+        } else if (arg == "--reps" && nextValue(value)) {
+            if (!parseReps(value, options.reps)) {
+                std::cerr << "Bad number for --reps: " << value << std::endl;
+                return false;
+            }
+        } else if (arg == "--baseline" && nextValue(value)) {
+            options.baseline_in = value;
+        } else if (arg == "--save-baseline" && nextValue(value)) {
+            options.baseline_out = value;
+        } else if (arg == "--threshold" && nextValue(value)) {
+            double percent = 0.0;
+            if (!parsePercent(value, percent)) {
+                std::cerr << "Bad number for --threshold: " << value << std::endl;
+                return false;
+            }
+            options.threshold = percent / 100.0;
+        } else {
+            std::cerr << "Unknown option: " << arg << "\n\n"
+                      << "Usage: vmm_bench [--filter SUBSTR] [--reps N]\n"
+                      << "                 [--save-baseline FILE] [--baseline FILE]\n"
+                      << "                 [--threshold PCT]" << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+int run(int argc, char* argv[]) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        return 1;
+    }
+
+    std::map<std::string, double> baseline;
+    if (!options.baseline_in.empty() && !loadBaseline(options.baseline_in, baseline)) {
+        std::cerr << "Failed to read baseline: " << options.baseline_in << std::endl;
+        return 1;
+    }
+
+    std::vector<Result> results;
+    benchPageTableLookup(results, options);
+    benchFaultHandling(results, options);
+    benchVictimSelection(results, options);
+    benchWorkloadGeneration(results, options);
+    benchJSONBuilding(results, options);
+
+    size_t regressions = 0;
+    std::cout << std::left << std::setw(32) << "benchmark"
+              << std::right << std::setw(12) << "ns/op"
+              << std::setw(14) << "cycles/op" << std::endl;
+    for (const Result& result : results) {
+        std::cout << std::left << std::setw(32) << result.name
+                  << std::right << std::setw(12) << std::fixed
+                  << std::setprecision(1) << result.ns_per_op;
+        if (result.cycles_per_op > 0.0) {
+            std::cout << std::setw(14) << std::setprecision(0) << result.cycles_per_op;
+        } else {
+            std::cout << std::setw(14) << "-";
+        }
+
+        auto it = baseline.find(result.name);
+        if (it != baseline.end() && it->second > 0.0) {
+            double delta = (result.ns_per_op - it->second) / it->second;
+            std::cout << "  " << std::showpos << std::setprecision(1)
+                      << delta * 100.0 << "%" << std::noshowpos;
+            if (delta > options.threshold) {
+                std::cout << "  REGRESSION";
+                regressions++;
+            }
+        }
+        std::cout << std::endl;
+    }
+
+    if (!options.baseline_out.empty()) {
+        if (!saveBaseline(options.baseline_out, results)) {
+            std::cerr << "Failed to write baseline: " << options.baseline_out << std::endl;
+            return 1;
+        }
+        std::cout << "\nBaseline written to " << options.baseline_out << std::endl;
+    }
+
+    if (regressions > 0) {
+        std::cout << "\n" << regressions << " benchmark(s) regressed beyond "
+                  << options.threshold * 100.0 << "% of baseline" << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+} // namespace microbench
+
+int main(int argc, char* argv[]) {
+    return microbench::run(argc, argv);
+}
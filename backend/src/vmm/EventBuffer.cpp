@@ -0,0 +1,61 @@
+#include "vmm/EventBuffer.h"
+
+namespace vmm {
+
+namespace {
+size_t roundUpPowerOfTwo(size_t value) {
+    size_t result = 1;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+} // namespace
+
+EventRingBuffer::EventRingBuffer(size_t capacity) {
+    size_t rounded = roundUpPowerOfTwo(capacity < 2 ? 2 : capacity);
+    buffer_.resize(rounded);
+    mask_ = rounded - 1;
+}
+
+bool EventRingBuffer::tryPush(const EventRecord& record) {
+    std::lock_guard<std::mutex> push_lock(push_mutex_);
+    size_t tail = tail_.load(std::memory_order_relaxed);
+    size_t head = head_.load(std::memory_order_acquire);
+    if (tail - head >= buffer_.size()) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    buffer_[tail & mask_] = record;
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+}
+
+bool EventRingBuffer::tryPop(EventRecord& record) {
+    size_t head = head_.load(std::memory_order_relaxed);
+    size_t tail = tail_.load(std::memory_order_acquire);
+    if (head == tail) {
+        return false;
+    }
+    record = buffer_[head & mask_];
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+}
+
+size_t EventRingBuffer::drain(std::vector<EventRecord>& out, size_t max_records) {
+    size_t drained = 0;
+    EventRecord record;
+    while (drained < max_records && tryPop(record)) {
+        out.push_back(record);
+        drained++;
+    }
+    return drained;
+}
+
+size_t EventRingBuffer::size() const {
+    size_t head = head_.load(std::memory_order_acquire);
+    size_t tail = tail_.load(std::memory_order_acquire);
+    return tail - head;
+}
+
+} // namespace vmm
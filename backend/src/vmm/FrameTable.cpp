@@ -0,0 +1,81 @@
+#include "vmm/FrameTable.h"
+
+namespace vmm {
+
+FrameTable::FrameTable(size_t num_frames) {
+    reset(num_frames);
+}
+
+void FrameTable::reset(size_t num_frames) {
+    entries_.assign(num_frames, FrameEntry{});
+}
+
+void FrameTable::assign(int frame, int address_space, int page) {
+    if (frame < 0 || frame >= static_cast<int>(entries_.size())) {
+        return;
+    }
+    FrameEntry& entry = entries_[frame];
+    entry.page = page;
+    entry.address_space = address_space;
+    entry.ref_count = 1;
+    entry.valid = true;
+    entry.dirty = false;
+    entry.referenced = true;
+}
+
+void FrameTable::addRef(int frame) {
+    if (frame < 0 || frame >= static_cast<int>(entries_.size())) {
+        return;
+    }
+    entries_[frame].ref_count++;
+}
+
+int FrameTable::dropRef(int frame) {
+    if (frame < 0 || frame >= static_cast<int>(entries_.size())) {
+        return 0;
+    }
+    FrameEntry& entry = entries_[frame];
+    if (entry.ref_count > 0) {
+        entry.ref_count--;
+    }
+    return entry.ref_count;
+}
+
+void FrameTable::release(int frame) {
+    if (frame < 0 || frame >= static_cast<int>(entries_.size())) {
+        return;
+    }
+    entries_[frame] = FrameEntry{};
+}
+
+void FrameTable::setOwner(int frame, int address_space, int page) {
+    if (frame < 0 || frame >= static_cast<int>(entries_.size())) {
+        return;
+    }
+    entries_[frame].address_space = address_space;
+    entries_[frame].page = page;
+}
+
+void FrameTable::recordAccess(int frame, size_t access_time) {
+    if (frame < 0 || frame >= static_cast<int>(entries_.size())) {
+        return;
+    }
+    entries_[frame].last_access = access_time;
+    entries_[frame].referenced = true;
+}
+
+void FrameTable::setDirty(int frame, bool dirty) {
+    if (frame < 0 || frame >= static_cast<int>(entries_.size())) {
+        return;
+    }
+    entries_[frame].dirty = dirty;
+}
+
+void FrameTable::clearReferenced(int frame) {
+    if (frame < 0 || frame >= static_cast<int>(entries_.size())) {
+        return;
+    }
+    entries_[frame].referenced = false;
+}
+
+} // namespace vmm
@@ -0,0 +1,113 @@
+#include "vmm/Instrumentation.h"
+#include <algorithm>
+
+namespace vmm {
+
+Instrumentation::Instrumentation(size_t total_pages, size_t sample_interval,
+                                 size_t window_size)
+    : sample_interval_(std::max<size_t>(1, sample_interval)),
+      window_size_(std::max<size_t>(1, window_size)),
+      last_access_(total_pages, 0),
+      heat_(total_pages, 0),
+      reuse_histogram_(64, 0),
+      page_epoch_(total_pages, 0) {
+}
+
+void Instrumentation::recordAccess(int page_number) {
+    size_t count = access_counter_.fetch_add(1, std::memory_order_relaxed);
+    if (count % sample_interval_ != 0) {
+        return;
+    }
+    recordSampledAccess(page_number);
+}
+
+void Instrumentation::recordSampledAccess(int page_number) {
+    if (page_number < 0 || page_number >= static_cast<int>(last_access_.size())) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    sampled_time_++;
+
+    // Reuse distance (log2 buckets, in sampled time)
+    size_t last = last_access_[page_number];
+    if (last != 0) {
+        size_t distance = sampled_time_ - last;
+        size_t bucket = 0;
+        while (distance > 1 && bucket < reuse_histogram_.size() - 1) {
+            distance >>= 1;
+            bucket++;
+        }
+        reuse_histogram_[bucket]++;
+    }
+    last_access_[page_number] = sampled_time_;
+    heat_[page_number]++;
+
+    // Working-set size per window of sampled accesses
+    if (page_epoch_[page_number] != current_epoch_) {
+        page_epoch_[page_number] = current_epoch_;
+        window_distinct_++;
+    }
+    window_position_++;
+    if (window_position_ >= window_size_) {
+        if (working_set_curve_.size() < MAX_CURVE_POINTS) {
+            working_set_curve_.emplace_back(
+                static_cast<uint64_t>(sampled_time_) * sample_interval_,
+                window_distinct_);
+        }
+        current_epoch_++;
+        window_distinct_ = 0;
+        window_position_ = 0;
+    }
+}
+
+std::vector<size_t> Instrumentation::getReuseDistanceHistogram() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    // Trim trailing empty buckets for compact export
+    std::vector<size_t> histogram = reuse_histogram_;
+    while (!histogram.empty() && histogram.back() == 0) {
+        histogram.pop_back();
+    }
+    return histogram;
+}
+
+std::vector<std::pair<uint64_t, size_t>> Instrumentation::getWorkingSetCurve() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return working_set_curve_;
+}
+
+std::vector<std::pair<int, size_t>> Instrumentation::getTopPages(size_t max_pages) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<std::pair<int, size_t>> pages;
+    for (size_t i = 0; i < heat_.size(); ++i) {
+        if (heat_[i] > 0) {
+            pages.emplace_back(static_cast<int>(i), heat_[i]);
+        }
+    }
+    std::sort(pages.begin(), pages.end(),
+              [](const auto& a, const auto& b) { return a.second > b.second; });
+    if (pages.size() > max_pages) {
+        pages.resize(max_pages);
+    }
+    return pages;
+}
+
+size_t Instrumentation::getSampledAccessCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return sampled_time_;
+}
+
+void Instrumentation::reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    sampled_time_ = 0;
+    std::fill(last_access_.begin(), last_access_.end(), 0);
+    std::fill(heat_.begin(), heat_.end(), 0);
+    std::fill(reuse_histogram_.begin(), reuse_histogram_.end(), 0);
+    std::fill(page_epoch_.begin(), page_epoch_.end(), 0);
+    current_epoch_ = 1;
+    window_distinct_ = 0;
+    window_position_ = 0;
+    working_set_curve_.clear();
+}
+
+} // namespace vmm
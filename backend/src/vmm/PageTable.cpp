@@ -3,57 +3,171 @@
 
 namespace vmm {
 
-PageTable::PageTable(size_t page_size, size_t total_pages) 
-    : page_size_(page_size), total_pages_(total_pages) {
+PageTable::PageTable(size_t page_size, size_t total_pages, bool dense_storage, size_t levels)
+    : dense_(dense_storage), levels_(std::max<size_t>(1, std::min<size_t>(levels, 4))),
+      page_size_(page_size), total_pages_(total_pages) {
+    if (levels_ >= 2) {
+        // Split the page-number bits evenly across the levels; the top
+        // levels index interior nodes, the last indexes a leaf's entries
+        size_t bits = 1;
+        while ((static_cast<size_t>(1) << bits) < total_pages_) {
+            bits++;
+        }
+        bits_per_level_ = (bits + levels_ - 1) / levels_;
+        radix_fanout_ = static_cast<size_t>(1) << bits_per_level_;
+        radix_root_ = std::make_unique<RadixNode>();
+    } else if (dense_) {
+        dense_pages_.resize(total_pages_);
+    }
+}
+
+const PageEntry* PageTable::findEntry(int page_number) const {
+    if (levels_ >= 2) {
+        if (page_number < 0) {
+            return nullptr;
+        }
+        const RadixNode* node = radix_root_.get();
+        for (size_t level = 0; level < levels_ - 1; ++level) {
+            size_t shift = bits_per_level_ * (levels_ - 1 - level);
+            size_t index = (static_cast<size_t>(page_number) >> shift) & (radix_fanout_ - 1);
+            if (index >= node->children.size() || !node->children[index]) {
+                return nullptr;
+            }
+            node = node->children[index].get();
+        }
+        size_t index = static_cast<size_t>(page_number) & (radix_fanout_ - 1);
+        if (index >= node->entries.size()) {
+            return nullptr;
+        }
+        return &node->entries[index];
+    }
+    if (dense_) {
+        if (page_number < 0 || page_number >= static_cast<int>(dense_pages_.size())) {
+            return nullptr;
+        }
+        return &dense_pages_[page_number];
+    }
+    auto it = sparse_pages_.find(page_number);
+    return (it != sparse_pages_.end()) ? &it->second : nullptr;
+}
+
+PageEntry& PageTable::touchEntry(int page_number) {
+    if (page_number < 0) {
+        // Mirror findEntry's nullptr behaviour for bad page numbers: hand
+        // back a scratch entry so the write lands nowhere, instead of
+        // resizing dense storage to page_number + 1 (near SIZE_MAX once
+        // the negative index is converted)
+        scratch_entry_ = PageEntry{};
+        return scratch_entry_;
+    }
+    if (levels_ >= 2) {
+        // Walk the radix tree, allocating interior nodes and the leaf
+        // entry block on first touch
+        RadixNode* node = radix_root_.get();
+        for (size_t level = 0; level < levels_ - 1; ++level) {
+            size_t shift = bits_per_level_ * (levels_ - 1 - level);
+            size_t index = (static_cast<size_t>(page_number) >> shift) & (radix_fanout_ - 1);
+            if (node->children.empty()) {
+                node->children.resize(radix_fanout_);
+            }
+            if (!node->children[index]) {
+                node->children[index] = std::make_unique<RadixNode>();
+            }
+            node = node->children[index].get();
+        }
+        if (node->entries.empty()) {
+            node->entries.resize(radix_fanout_);
+        }
+        return node->entries[static_cast<size_t>(page_number) & (radix_fanout_ - 1)];
+    }
+    if (dense_) {
+        if (page_number >= static_cast<int>(dense_pages_.size())) {
+            // Grow to cover out-of-range pages rather than crash; callers
+            // are expected to stay within total_pages_.
+            dense_pages_.resize(static_cast<size_t>(page_number) + 1);
+        }
+        return dense_pages_[page_number];
+    }
+    return sparse_pages_[page_number];
+}
+
+void PageTable::collectValidPages(const RadixNode& node, int base, size_t level,
+                                  std::vector<int>& out) const {
+    if (level == levels_ - 1) {
+        for (size_t i = 0; i < node.entries.size(); ++i) {
+            if (node.entries[i].valid) {
+                out.push_back(base + static_cast<int>(i));
+            }
+        }
+        return;
+    }
+    size_t shift = bits_per_level_ * (levels_ - 1 - level);
+    for (size_t i = 0; i < node.children.size(); ++i) {
+        if (node.children[i]) {
+            collectValidPages(*node.children[i],
+                              base + static_cast<int>(i << shift), level + 1, out);
+        }
+    }
 }
 
 bool PageTable::isPageValid(int page_number) const {
     std::lock_guard<std::mutex> lock(mutex_);
-    auto it = pages_.find(page_number);
-    return it != pages_.end() && it->second.valid;
+    const PageEntry* entry = findEntry(page_number);
+    return entry != nullptr && entry->valid;
 }
 
 bool PageTable::isPageReferenced(int page_number) const {
     std::lock_guard<std::mutex> lock(mutex_);
-    auto it = pages_.find(page_number);
-    return it != pages_.end() && it->second.referenced;
+    const PageEntry* entry = findEntry(page_number);
+    return entry != nullptr && entry->referenced;
 }
 
 bool PageTable::isPageModified(int page_number) const {
     std::lock_guard<std::mutex> lock(mutex_);
-    auto it = pages_.find(page_number);
-    return it != pages_.end() && it->second.modified;
+    const PageEntry* entry = findEntry(page_number);
+    return entry != nullptr && entry->modified;
+}
+
+bool PageTable::isPageCOW(int page_number) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const PageEntry* entry = findEntry(page_number);
+    return entry != nullptr && entry->cow;
 }
 
 int PageTable::getFrameNumber(int page_number) const {
     std::lock_guard<std::mutex> lock(mutex_);
-    auto it = pages_.find(page_number);
-    return (it != pages_.end() && it->second.valid) ? it->second.frame_number : -1;
+    const PageEntry* entry = findEntry(page_number);
+    return (entry != nullptr && entry->valid) ? entry->frame_number : -1;
 }
 
 void PageTable::setPageValid(int page_number, bool valid) {
     std::lock_guard<std::mutex> lock(mutex_);
-    pages_[page_number].valid = valid;
+    touchEntry(page_number).valid = valid;
 }
 
 void PageTable::setPageReferenced(int page_number, bool referenced) {
     std::lock_guard<std::mutex> lock(mutex_);
-    pages_[page_number].referenced = referenced;
+    touchEntry(page_number).referenced = referenced;
 }
 
 void PageTable::setPageModified(int page_number, bool modified) {
     std::lock_guard<std::mutex> lock(mutex_);
-    pages_[page_number].modified = modified;
+    touchEntry(page_number).modified = modified;
+}
+
+void PageTable::setPageCOW(int page_number, bool cow) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    touchEntry(page_number).cow = cow;
 }
 
 void PageTable::setFrameNumber(int page_number, int frame_number) {
     std::lock_guard<std::mutex> lock(mutex_);
-    pages_[page_number].frame_number = frame_number;
+    touchEntry(page_number).frame_number = frame_number;
 }
 
 void PageTable::recordPageAccess(int page_number, size_t current_time) {
     std::lock_guard<std::mutex> lock(mutex_);
-    auto& entry = pages_[page_number];
+    auto& entry = touchEntry(page_number);
     entry.referenced = true;
     entry.access_count++;
     entry.last_access_time = current_time;
@@ -61,22 +175,35 @@ void PageTable::recordPageAccess(int page_number, size_t current_time) {
 
 int PageTable::getAccessCount(int page_number) const {
     std::lock_guard<std::mutex> lock(mutex_);
-    auto it = pages_.find(page_number);
-    return (it != pages_.end()) ? it->second.access_count : 0;
+    const PageEntry* entry = findEntry(page_number);
+    return (entry != nullptr) ? entry->access_count : 0;
 }
 
 size_t PageTable::getLastAccessTime(int page_number) const {
     std::lock_guard<std::mutex> lock(mutex_);
-    auto it = pages_.find(page_number);
-    return (it != pages_.end()) ? it->second.last_access_time : 0;
+    const PageEntry* entry = findEntry(page_number);
+    return (entry != nullptr) ? entry->last_access_time : 0;
 }
 
 size_t PageTable::getValidPageCount() const {
     std::lock_guard<std::mutex> lock(mutex_);
     size_t count = 0;
-    for (const auto& pair : pages_) {
-        if (pair.second.valid) {
-            count++;
+    if (levels_ >= 2) {
+        std::vector<int> pages;
+        collectValidPages(*radix_root_, 0, 0, pages);
+        return pages.size();
+    }
+    if (dense_) {
+        for (const auto& entry : dense_pages_) {
+            if (entry.valid) {
+                count++;
+            }
+        }
+    } else {
+        for (const auto& pair : sparse_pages_) {
+            if (pair.second.valid) {
+                count++;
+            }
         }
     }
     return count;
@@ -85,9 +212,21 @@ size_t PageTable::getValidPageCount() const {
 std::vector<int> PageTable::getValidPages() const {
     std::lock_guard<std::mutex> lock(mutex_);
     std::vector<int> valid_pages;
-    for (const auto& pair : pages_) {
-        if (pair.second.valid) {
-            valid_pages.push_back(pair.first);
+    if (levels_ >= 2) {
+        collectValidPages(*radix_root_, 0, 0, valid_pages);
+        return valid_pages;
+    }
+    if (dense_) {
+        for (size_t i = 0; i < dense_pages_.size(); ++i) {
+            if (dense_pages_[i].valid) {
+                valid_pages.push_back(static_cast<int>(i));
+            }
+        }
+    } else {
+        for (const auto& pair : sparse_pages_) {
+            if (pair.second.valid) {
+                valid_pages.push_back(pair.first);
+            }
         }
     }
     return valid_pages;
@@ -95,7 +234,13 @@ std::vector<int> PageTable::getValidPages() const {
 
 void PageTable::clear() {
     std::lock_guard<std::mutex> lock(mutex_);
-    pages_.clear();
+    if (levels_ >= 2) {
+        radix_root_ = std::make_unique<RadixNode>();
+    }
+    if (dense_) {
+        std::fill(dense_pages_.begin(), dense_pages_.end(), PageEntry());
+    }
+    sparse_pages_.clear();
 }
 
 std::lock_guard<std::mutex> PageTable::getLock() const {
@@ -0,0 +1,110 @@
+#include "vmm/PredictorChannel.h"
+#include <iostream>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cstring>
+#endif
+
+namespace vmm {
+
+namespace {
+
+size_t roundDownPowerOfTwo(size_t value) {
+    size_t result = 1;
+    while (result * 2 <= value) {
+        result *= 2;
+    }
+    return result;
+}
+
+} // namespace
+
+PredictorChannel::PredictorChannel(const std::string& name, size_t ring_capacity)
+    : name_(name),
+      ring_capacity_(roundDownPowerOfTwo(ring_capacity < 64 ? 64 : ring_capacity)) {
+#ifdef _WIN32
+    // Not supported on Windows; the caller falls back to the built-in
+    // heuristic predictor
+    (void)ring_capacity;
+#else
+    mapping_size_ = sizeof(ChannelHeader) + 2 * ring_capacity_ * sizeof(int32_t);
+
+    int fd = shm_open(name_.c_str(), O_CREAT | O_RDWR, 0600);
+    if (fd < 0) {
+        std::cerr << "Failed to create predictor channel: " << name_ << std::endl;
+        return;
+    }
+    if (ftruncate(fd, static_cast<off_t>(mapping_size_)) != 0) {
+        close(fd);
+        shm_unlink(name_.c_str());
+        return;
+    }
+    void* data = mmap(nullptr, mapping_size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        std::cerr << "Failed to map predictor channel: " << name_ << std::endl;
+        shm_unlink(name_.c_str());
+        return;
+    }
+
+    mapping_ = data;
+    std::memset(mapping_, 0, mapping_size_);
+    header_ = static_cast<ChannelHeader*>(mapping_);
+    access_slots_ = reinterpret_cast<int32_t*>(
+        static_cast<char*>(mapping_) + sizeof(ChannelHeader));
+    prediction_slots_ = access_slots_ + ring_capacity_;
+
+    header_->ring_capacity = static_cast<uint32_t>(ring_capacity_);
+    header_->version = VERSION;
+    // Magic last: a sidecar that maps mid-initialization sees it unset
+    header_->magic = MAGIC;
+#endif
+}
+
+PredictorChannel::~PredictorChannel() {
+#ifndef _WIN32
+    if (mapping_ != nullptr) {
+        munmap(mapping_, mapping_size_);
+        shm_unlink(name_.c_str());
+    }
+#endif
+}
+
+void PredictorChannel::pushAccess(int page_number) {
+    if (header_ == nullptr) {
+        return;
+    }
+    uint64_t head = header_->access_head.load(std::memory_order_relaxed);
+    uint64_t tail = header_->access_tail.load(std::memory_order_acquire);
+    if (head - tail >= ring_capacity_) {
+        // Sidecar is behind; drop rather than stall the access path
+        dropped_accesses_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    access_slots_[head & (ring_capacity_ - 1)] = static_cast<int32_t>(page_number);
+    header_->access_head.store(head + 1, std::memory_order_release);
+}
+
+size_t PredictorChannel::pollPredictions(std::vector<int>& out, size_t max_records) {
+    if (header_ == nullptr) {
+        return 0;
+    }
+    uint64_t tail = header_->prediction_tail.load(std::memory_order_relaxed);
+    uint64_t head = header_->prediction_head.load(std::memory_order_acquire);
+    size_t drained = 0;
+    while (tail < head && drained < max_records) {
+        out.push_back(prediction_slots_[tail & (ring_capacity_ - 1)]);
+        tail++;
+        drained++;
+    }
+    if (drained > 0) {
+        header_->prediction_tail.store(tail, std::memory_order_release);
+    }
+    return drained;
+}
+
+} // namespace vmm
@@ -5,12 +5,11 @@
 namespace vmm {
 
 // FIFO Implementation
-int FIFOReplacement::selectVictimFrame(const std::vector<bool>& frame_validity, 
-                                       const PageTable& page_table) {
+int FIFOReplacement::selectVictimFrame(const FrameTable& frames) {
     // Find the first frame that's valid and in our queue
     while (!fifo_queue_.empty()) {
         int frame = fifo_queue_.front();
-        if (frame_validity[frame]) {
+        if (frames.isValid(frame)) {
             return frame;
         }
         fifo_queue_.pop();
@@ -26,38 +25,93 @@ void FIFOReplacement::recordFrameAccess(int frame_number) {
     }
 }
 
-void FIFOReplacement::recordFrameEviction(int frame_number) {
+void FIFOReplacement::recordFrameEviction(int /*frame_number*/) {
     // FIFO doesn't need special handling for evictions
 }
 
 // LRU Implementation
-LRUReplacement::LRUReplacement(size_t num_frames) 
-    : last_access_times_(num_frames, 0) {
-}
-
-int LRUReplacement::selectVictimFrame(const std::vector<bool>& frame_validity, 
-                                      const PageTable& page_table) {
+int LRUReplacement::selectVictimFrame(const FrameTable& frames) {
     size_t oldest_time = ULLONG_MAX;
     int victim_frame = -1;
-    
-    for (size_t i = 0; i < frame_validity.size(); ++i) {
-        if (frame_validity[i] && last_access_times_[i] < oldest_time) {
-            oldest_time = last_access_times_[i];
+
+    for (size_t i = 0; i < frames.size(); ++i) {
+        const FrameEntry& entry = frames.entry(i);
+        if (entry.valid && entry.last_access < oldest_time) {
+            oldest_time = entry.last_access;
             victim_frame = static_cast<int>(i);
         }
     }
-    
+
     return victim_frame;
 }
 
-void LRUReplacement::recordFrameAccess(int frame_number) {
-    if (frame_number >= 0 && frame_number < static_cast<int>(last_access_times_.size())) {
-        last_access_times_[frame_number] = current_time_++;
+// LRU_FAST Implementation
+LRUFastReplacement::LRUFastReplacement(size_t num_frames)
+    : prev_(num_frames, -1), next_(num_frames, -1), linked_(num_frames, false) {
+}
+
+void LRUFastReplacement::unlink(int frame_number) {
+    if (!linked_[frame_number]) {
+        return;
+    }
+    int prev = prev_[frame_number];
+    int next = next_[frame_number];
+    if (prev != -1) {
+        next_[prev] = next;
+    } else {
+        head_ = next;
+    }
+    if (next != -1) {
+        prev_[next] = prev;
+    } else {
+        tail_ = prev;
+    }
+    prev_[frame_number] = -1;
+    next_[frame_number] = -1;
+    linked_[frame_number] = false;
+}
+
+void LRUFastReplacement::linkAtTail(int frame_number) {
+    prev_[frame_number] = tail_;
+    next_[frame_number] = -1;
+    if (tail_ != -1) {
+        next_[tail_] = frame_number;
+    } else {
+        head_ = frame_number;
+    }
+    tail_ = frame_number;
+    linked_[frame_number] = true;
+}
+
+int LRUFastReplacement::selectVictimFrame(const FrameTable& frames) {
+    // Walk from the LRU end; normally the head is valid and this is O(1).
+    int frame = head_;
+    while (frame != -1) {
+        if (frames.isValid(frame)) {
+            return frame;
+        }
+        int next = next_[frame];
+        unlink(frame);
+        frame = next;
+    }
+    return -1; // No victim found
+}
+
+void LRUFastReplacement::recordFrameAccess(int frame_number) {
+    if (frame_number < 0 || frame_number >= static_cast<int>(linked_.size())) {
+        return;
+    }
+    if (frame_number == tail_) {
+        return; // Already most recently used
     }
+    unlink(frame_number);
+    linkAtTail(frame_number);
 }
 
-void LRUReplacement::recordFrameEviction(int frame_number) {
-    // LRU doesn't need special handling for evictions
+void LRUFastReplacement::recordFrameEviction(int frame_number) {
+    if (frame_number >= 0 && frame_number < static_cast<int>(linked_.size())) {
+        unlink(frame_number);
+    }
 }
 
 // CLOCK Implementation
@@ -65,46 +119,276 @@ CLOCKReplacement::CLOCKReplacement(size_t num_frames)
     : reference_bits_(num_frames, false) {
 }
 
-int CLOCKReplacement::selectVictimFrame(const std::vector<bool>& frame_validity, 
-                                        const PageTable& page_table) {
+int CLOCKReplacement::selectVictimFrame(const FrameTable& frames) {
     int start_hand = clock_hand_;
-    
+
     // First pass: look for unreferenced frame
     do {
-        if (frame_validity[clock_hand_] && !reference_bits_[clock_hand_]) {
+        if (frames.isValid(clock_hand_) && !reference_bits_[clock_hand_]) {
             int victim = clock_hand_;
-            clock_hand_ = (clock_hand_ + 1) % frame_validity.size();
+            clock_hand_ = (clock_hand_ + 1) % frames.size();
             return victim;
         }
-        clock_hand_ = (clock_hand_ + 1) % frame_validity.size();
+        clock_hand_ = (clock_hand_ + 1) % frames.size();
     } while (clock_hand_ != start_hand);
-    
+
     // Second pass: clear reference bits and find victim
     do {
-        if (frame_validity[clock_hand_]) {
+        if (frames.isValid(clock_hand_)) {
             if (!reference_bits_[clock_hand_]) {
                 int victim = clock_hand_;
-                clock_hand_ = (clock_hand_ + 1) % frame_validity.size();
+                clock_hand_ = (clock_hand_ + 1) % frames.size();
                 return victim;
             } else {
                 reference_bits_[clock_hand_] = false;
             }
         }
-        clock_hand_ = (clock_hand_ + 1) % frame_validity.size();
+        clock_hand_ = (clock_hand_ + 1) % frames.size();
     } while (clock_hand_ != start_hand);
-    
+
     return -1; // No victim found
 }
 
-void CLOCKReplacement::recordFrameAccess(int frame_number) {
+void CLOCKReplacement::recordFrameEviction(int frame_number) {
     if (frame_number >= 0 && frame_number < static_cast<int>(reference_bits_.size())) {
-        reference_bits_[frame_number] = true;
+        reference_bits_[frame_number] = false;
     }
 }
 
-void CLOCKReplacement::recordFrameEviction(int frame_number) {
-    if (frame_number >= 0 && frame_number < static_cast<int>(reference_bits_.size())) {
-        reference_bits_[frame_number] = false;
+// OPT Implementation
+void OPTReplacement::setFutureTrace(const std::vector<int>& future_pages) {
+    // Build the per-page next-use index once: next_uses_[p] lists every
+    // position at which p is accessed, in order
+    int max_page = -1;
+    for (int page : future_pages) {
+        max_page = std::max(max_page, page);
+    }
+    next_uses_.assign(max_page + 1, {});
+    next_use_cursor_.assign(max_page + 1, 0);
+    for (size_t i = 0; i < future_pages.size(); ++i) {
+        if (future_pages[i] >= 0) {
+            next_uses_[future_pages[i]].push_back(i);
+        }
+    }
+    position_ = 0;
+}
+
+void OPTReplacement::recordPageAccess(int page_number) {
+    // Advance past this use so the cursor always points at the page's
+    // next use strictly after the current position
+    if (page_number >= 0 && page_number < static_cast<int>(next_uses_.size())) {
+        const auto& uses = next_uses_[page_number];
+        size_t& cursor = next_use_cursor_[page_number];
+        while (cursor < uses.size() && uses[cursor] <= position_) {
+            cursor++;
+        }
+    }
+    position_++;
+}
+
+int OPTReplacement::selectVictimFrame(const FrameTable& frames) {
+    // The resident page comes straight from the frame table; OPT no
+    // longer shadows the frame->page mapping
+    size_t farthest_use = 0;
+    int victim_frame = -1;
+
+    for (size_t i = 0; i < frames.size(); ++i) {
+        const FrameEntry& entry = frames.entry(i);
+        if (!entry.valid) {
+            continue;
+        }
+        int page = entry.page;
+        if (page < 0 || page >= static_cast<int>(next_uses_.size())) {
+            return static_cast<int>(i); // unknown page: never used again
+        }
+        const auto& uses = next_uses_[page];
+        size_t cursor = next_use_cursor_[page];
+        if (cursor >= uses.size()) {
+            return static_cast<int>(i); // no future use: perfect victim
+        }
+        if (uses[cursor] > farthest_use || victim_frame == -1) {
+            farthest_use = uses[cursor];
+            victim_frame = static_cast<int>(i);
+        }
+    }
+    return victim_frame;
+}
+
+void OPTReplacement::recordFrameAccess(int frame_number) {
+    (void)frame_number; // OPT works from the page stream, not frame order
+}
+
+// 2Q Implementation
+TwoQReplacement::TwoQReplacement(size_t num_frames)
+    : position_(num_frames), location_(num_frames, Location::NONE) {
+}
+
+void TwoQReplacement::remove(int frame_number) {
+    switch (location_[frame_number]) {
+        case Location::A1IN:
+            a1in_.erase(position_[frame_number]);
+            break;
+        case Location::AM:
+            am_.erase(position_[frame_number]);
+            break;
+        case Location::NONE:
+            break;
+    }
+    location_[frame_number] = Location::NONE;
+}
+
+void TwoQReplacement::recordFrameAccess(int frame_number) {
+    if (frame_number < 0 || frame_number >= static_cast<int>(location_.size())) {
+        return;
+    }
+    switch (location_[frame_number]) {
+        case Location::NONE:
+            // First touch: probation FIFO
+            a1in_.push_back(frame_number);
+            position_[frame_number] = std::prev(a1in_.end());
+            location_[frame_number] = Location::A1IN;
+            break;
+        case Location::A1IN:
+            // Re-access: promote to the protected LRU list
+            a1in_.erase(position_[frame_number]);
+            am_.push_back(frame_number);
+            position_[frame_number] = std::prev(am_.end());
+            location_[frame_number] = Location::AM;
+            break;
+        case Location::AM:
+            // Move to MRU end
+            am_.splice(am_.end(), am_, position_[frame_number]);
+            break;
+    }
+}
+
+int TwoQReplacement::selectVictimFrame(const FrameTable& frames) {
+    // Probation queue first, then the protected list's LRU end. The
+    // victim is unlinked here so its next access re-enters probation.
+    while (!a1in_.empty()) {
+        int frame = a1in_.front();
+        a1in_.pop_front();
+        location_[frame] = Location::NONE;
+        if (frames.isValid(frame)) {
+            return frame;
+        }
+    }
+    while (!am_.empty()) {
+        int frame = am_.front();
+        am_.pop_front();
+        location_[frame] = Location::NONE;
+        if (frames.isValid(frame)) {
+            return frame;
+        }
+    }
+    return -1;
+}
+
+void TwoQReplacement::recordFrameEviction(int frame_number) {
+    if (frame_number >= 0 && frame_number < static_cast<int>(location_.size())) {
+        remove(frame_number);
+    }
+}
+
+// Active/Inactive Implementation
+ActiveInactiveReplacement::ActiveInactiveReplacement(size_t num_frames)
+    : position_(num_frames), location_(num_frames, ListId::NONE) {
+}
+
+void ActiveInactiveReplacement::remove(int frame_number) {
+    switch (location_[frame_number]) {
+        case ListId::ACTIVE:
+            active_.erase(position_[frame_number]);
+            break;
+        case ListId::INACTIVE:
+            inactive_.erase(position_[frame_number]);
+            break;
+        case ListId::NONE:
+            break;
+    }
+    location_[frame_number] = ListId::NONE;
+}
+
+int ActiveInactiveReplacement::selectVictimFrame(const FrameTable& frames) {
+    // The daemon keeps the inactive tail cold, so the common case is a
+    // single pop with no reference-bit scanning
+    while (!inactive_.empty()) {
+        int frame = inactive_.back();
+        inactive_.pop_back();
+        location_[frame] = ListId::NONE;
+        if (frames.isValid(frame)) {
+            return frame;
+        }
+    }
+    // Pressure outran the daemon: fall back to the active tail
+    while (!active_.empty()) {
+        int frame = active_.back();
+        active_.pop_back();
+        location_[frame] = ListId::NONE;
+        if (frames.isValid(frame)) {
+            return frame;
+        }
+    }
+    return -1;
+}
+
+void ActiveInactiveReplacement::recordFrameEviction(int frame_number) {
+    if (frame_number >= 0 && frame_number < static_cast<int>(location_.size())) {
+        remove(frame_number);
+    }
+}
+
+// One bounded increment of background aging. Runs off the access path
+// (VMM::agingLoop, under replacement_mutex_); `budget` caps how many
+// frames are examined, so a tick's cost never scales with the frame
+// count.
+void ActiveInactiveReplacement::ageTick(FrameTable& frames, size_t budget) {
+    size_t scanned = 0;
+
+    // Promote: inactive frames that were touched since the daemon last
+    // looked earned their way onto the active list. Stop at the first
+    // cold tail frame — that is exactly the victim we want to keep
+    // ready.
+    while (scanned < budget && !inactive_.empty()) {
+        int frame = inactive_.back();
+        scanned++;
+        if (!frames.isValid(frame)) {
+            inactive_.pop_back();
+            location_[frame] = ListId::NONE;
+            continue;
+        }
+        if (!frames.entry(frame).referenced) {
+            break;
+        }
+        frames.clearReferenced(frame);
+        inactive_.pop_back();
+        active_.push_front(frame);
+        position_[frame] = active_.begin();
+        location_[frame] = ListId::ACTIVE;
+    }
+
+    // Demote: keep roughly a third of resident frames on the inactive
+    // list so eviction candidates never run dry. Referenced frames at
+    // the active tail get a second chance at the head.
+    size_t resident = active_.size() + inactive_.size();
+    while (scanned < budget && !active_.empty() &&
+           inactive_.size() < resident / 3 + 1) {
+        int frame = active_.back();
+        scanned++;
+        active_.pop_back();
+        if (!frames.isValid(frame)) {
+            location_[frame] = ListId::NONE;
+            continue;
+        }
+        if (frames.entry(frame).referenced) {
+            frames.clearReferenced(frame);
+            active_.push_front(frame);
+            position_[frame] = active_.begin();
+        } else {
+            inactive_.push_front(frame);
+            position_[frame] = inactive_.begin();
+            location_[frame] = ListId::INACTIVE;
+        }
     }
 }
 
@@ -114,34 +398,60 @@ ReplacementManager::ReplacementManager(ReplacementPolicy policy, size_t num_fram
     setPolicy(policy);
 }
 
-int ReplacementManager::selectVictimFrame(const std::vector<bool>& frame_validity, 
-                                         const PageTable& page_table) {
-    return algorithm_->selectVictimFrame(frame_validity, page_table);
-}
-
-void ReplacementManager::recordFrameAccess(int frame_number) {
-    algorithm_->recordFrameAccess(frame_number);
+int ReplacementManager::selectVictimFrame(const FrameTable& frames) {
+    return algorithm_->selectVictimFrame(frames);
 }
 
 void ReplacementManager::recordFrameEviction(int frame_number) {
     algorithm_->recordFrameEviction(frame_number);
 }
 
+void ReplacementManager::recordPageAccess(int page_number) {
+    algorithm_->recordPageAccess(page_number);
+}
+
+void ReplacementManager::recordPagePlacement(int frame_number, int page_number) {
+    algorithm_->recordPagePlacement(frame_number, page_number);
+}
+
+void ReplacementManager::setFutureTrace(const std::vector<int>& future_pages) {
+    algorithm_->setFutureTrace(future_pages);
+}
+
+void ReplacementManager::ageTick(FrameTable& frames, size_t budget) {
+    if (policy_ == ReplacementPolicy::ACTIVE_INACTIVE) {
+        static_cast<ActiveInactiveReplacement*>(algorithm_.get())->ageTick(frames, budget);
+    }
+}
+
 std::string ReplacementManager::getPolicyName() const {
     return algorithm_->getPolicyName();
 }
 
 void ReplacementManager::setPolicy(ReplacementPolicy policy) {
+    policy_ = policy;
     switch (policy) {
         case ReplacementPolicy::FIFO:
             algorithm_ = std::make_unique<FIFOReplacement>();
             break;
         case ReplacementPolicy::LRU:
-            algorithm_ = std::make_unique<LRUReplacement>(num_frames_);
+            algorithm_ = std::make_unique<LRUReplacement>();
+            break;
+        case ReplacementPolicy::LRU_FAST:
+            algorithm_ = std::make_unique<LRUFastReplacement>(num_frames_);
             break;
         case ReplacementPolicy::CLOCK:
             algorithm_ = std::make_unique<CLOCKReplacement>(num_frames_);
             break;
+        case ReplacementPolicy::OPT:
+            algorithm_ = std::make_unique<OPTReplacement>();
+            break;
+        case ReplacementPolicy::TWO_Q:
+            algorithm_ = std::make_unique<TwoQReplacement>(num_frames_);
+            break;
+        case ReplacementPolicy::ACTIVE_INACTIVE:
+            algorithm_ = std::make_unique<ActiveInactiveReplacement>(num_frames_);
+            break;
     }
 }
 
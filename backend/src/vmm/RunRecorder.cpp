@@ -0,0 +1,216 @@
+#include "vmm/RunRecorder.h"
+#include <chrono>
+
+namespace vmm {
+
+namespace {
+
+uint64_t nowMs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+} // namespace
+
+const std::vector<std::string>& RunRecorder::columnNames() {
+    static const std::vector<std::string> names = {
+        "timestamp_ms",
+        "total_accesses",
+        "page_faults",
+        "swap_ins",
+        "swap_outs",
+        "ai_predictions",
+        "ai_hits",
+        "tlb_hits",
+        "tlb_misses",
+        "cluster_prefetches",
+        "numa_local_allocations",
+        "numa_remote_allocations",
+        "free_frames",
+        "used_frames",
+    };
+    return names;
+}
+
+RunRecorder::Block::Block(size_t column_count) : columns(column_count) {
+    for (auto& column : columns) {
+        column.reserve(BLOCK_ROWS);
+    }
+}
+
+void RunRecorder::Block::clear() {
+    for (auto& column : columns) {
+        column.clear();
+    }
+    rows = 0;
+}
+
+RunRecorder::RunRecorder(const VMM& vmm, const std::string& path, size_t interval_ms)
+    : vmm_(vmm),
+      interval_ms_(interval_ms > 0 ? interval_ms : 1),
+      active_(columnNames().size()),
+      flushing_(columnNames().size()) {
+    file_.open(path, std::ios::binary | std::ios::trunc);
+    if (file_.is_open()) {
+        writeHeader();
+    }
+}
+
+RunRecorder::~RunRecorder() {
+    stop();
+}
+
+void RunRecorder::start() {
+    if (!file_.is_open() || running_.exchange(true)) {
+        return;
+    }
+    writer_thread_ = std::thread(&RunRecorder::writerLoop, this);
+    sampler_thread_ = std::thread(&RunRecorder::samplerLoop, this);
+}
+
+void RunRecorder::stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+    flush_cv_.notify_all();
+    if (sampler_thread_.joinable()) {
+        sampler_thread_.join();
+    }
+    if (writer_thread_.joinable()) {
+        writer_thread_.join();
+    }
+    // Whatever the sampler left behind is flushed inline; both threads
+    // are gone so no locking is needed past this point
+    if (flush_pending_) {
+        writeBlock(flushing_);
+        flushing_.clear();
+        flush_pending_ = false;
+    }
+    if (active_.rows > 0) {
+        writeBlock(active_);
+        active_.clear();
+    }
+    writeFooter();
+    file_.close();
+}
+
+void RunRecorder::sample() {
+    VMMMetricsSnapshot snapshot = vmm_.getMetricsSnapshot();
+    uint64_t values[] = {
+        nowMs(),
+        snapshot.total_accesses,
+        snapshot.page_faults,
+        snapshot.swap_ins,
+        snapshot.swap_outs,
+        snapshot.ai_predictions,
+        snapshot.ai_hits,
+        snapshot.tlb_hits,
+        snapshot.tlb_misses,
+        snapshot.cluster_prefetches,
+        snapshot.numa_local_allocations,
+        snapshot.numa_remote_allocations,
+        snapshot.free_frames,
+        snapshot.used_frames,
+    };
+
+    std::unique_lock<std::mutex> lock(swap_mutex_);
+    for (size_t c = 0; c < active_.columns.size(); ++c) {
+        active_.columns[c].push_back(values[c]);
+    }
+    active_.rows++;
+    samples_taken_.fetch_add(1, std::memory_order_relaxed);
+
+    if (active_.rows >= BLOCK_ROWS && !flush_pending_) {
+        // Hand the filled block to the writer and keep sampling into
+        // the (empty) spare. If the writer is still busy with the
+        // previous block we just keep appending past BLOCK_ROWS --
+        // samples are never dropped, blocks just grow.
+        std::swap(active_, flushing_);
+        flush_pending_ = true;
+        lock.unlock();
+        flush_cv_.notify_one();
+    }
+}
+
+void RunRecorder::samplerLoop() {
+    while (running_.load(std::memory_order_relaxed)) {
+        sample();
+        std::this_thread::sleep_for(std::chrono::milliseconds(interval_ms_));
+    }
+    // Final sample so the last row reflects end-of-run totals
+    sample();
+}
+
+void RunRecorder::writerLoop() {
+    std::unique_lock<std::mutex> lock(swap_mutex_);
+    while (true) {
+        flush_cv_.wait(lock, [this] {
+            return flush_pending_ || !running_.load(std::memory_order_relaxed);
+        });
+        if (flush_pending_) {
+            // File I/O happens outside the lock; the sampler only ever
+            // touches active_, so flushing_ is ours until we clear the
+            // pending flag
+            lock.unlock();
+            writeBlock(flushing_);
+            flushing_.clear();
+            lock.lock();
+            flush_pending_ = false;
+        } else if (!running_.load(std::memory_order_relaxed)) {
+            return;
+        }
+    }
+}
+
+void RunRecorder::writeHeader() {
+    uint32_t magic = MAGIC;
+    uint32_t version = VERSION;
+    uint32_t column_count = static_cast<uint32_t>(columnNames().size());
+    uint32_t interval = static_cast<uint32_t>(interval_ms_);
+    file_.write(reinterpret_cast<const char*>(&magic), sizeof(magic));
+    file_.write(reinterpret_cast<const char*>(&version), sizeof(version));
+    file_.write(reinterpret_cast<const char*>(&column_count), sizeof(column_count));
+    file_.write(reinterpret_cast<const char*>(&interval), sizeof(interval));
+}
+
+void RunRecorder::writeBlock(const Block& block) {
+    if (block.rows == 0 || !file_.is_open()) {
+        return;
+    }
+    BlockIndexEntry entry;
+    entry.offset = static_cast<uint64_t>(file_.tellp());
+    entry.rows = static_cast<uint32_t>(block.rows);
+
+    file_.write(reinterpret_cast<const char*>(&entry.rows), sizeof(entry.rows));
+    for (const auto& column : block.columns) {
+        file_.write(reinterpret_cast<const char*>(column.data()),
+                    static_cast<std::streamsize>(column.size() * sizeof(uint64_t)));
+    }
+    block_index_.push_back(entry);
+}
+
+void RunRecorder::writeFooter() {
+    if (!file_.is_open()) {
+        return;
+    }
+    uint64_t footer_offset = static_cast<uint64_t>(file_.tellp());
+
+    uint32_t block_count = static_cast<uint32_t>(block_index_.size());
+    file_.write(reinterpret_cast<const char*>(&block_count), sizeof(block_count));
+    for (const auto& entry : block_index_) {
+        file_.write(reinterpret_cast<const char*>(&entry.offset), sizeof(entry.offset));
+        file_.write(reinterpret_cast<const char*>(&entry.rows), sizeof(entry.rows));
+    }
+    for (const auto& name : columnNames()) {
+        uint32_t len = static_cast<uint32_t>(name.size());
+        file_.write(reinterpret_cast<const char*>(&len), sizeof(len));
+        file_.write(name.data(), static_cast<std::streamsize>(name.size()));
+    }
+
+    uint32_t magic = MAGIC;
+    file_.write(reinterpret_cast<const char*>(&footer_offset), sizeof(footer_offset));
+    file_.write(reinterpret_cast<const char*>(&magic), sizeof(magic));
+    file_.flush();
+}
+
+} // namespace vmm
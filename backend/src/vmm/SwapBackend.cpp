@@ -0,0 +1,149 @@
+#include "vmm/SwapBackend.h"
+#include <algorithm>
+#include <chrono>
+
+namespace vmm {
+
+SwapDeviceModel SwapDeviceModel::forProfile(SwapDeviceProfile profile) {
+    switch (profile) {
+        case SwapDeviceProfile::NVME:
+            return {15.0, 20.0, 2500.0};
+        case SwapDeviceProfile::SSD:
+            return {80.0, 90.0, 500.0};
+        case SwapDeviceProfile::HDD:
+            return {6000.0, 7000.0, 150.0};
+    }
+    return {};
+}
+
+const char* SwapBackend::profileName(SwapDeviceProfile profile) {
+    switch (profile) {
+        case SwapDeviceProfile::NVME: return "nvme";
+        case SwapDeviceProfile::SSD: return "ssd";
+        case SwapDeviceProfile::HDD: return "hdd";
+    }
+    return "unknown";
+}
+
+SwapBackend::SwapBackend(SwapDeviceProfile profile, size_t page_size, size_t queue_capacity)
+    : model_(SwapDeviceModel::forProfile(profile)),
+      page_size_(page_size),
+      queue_capacity_(std::max<size_t>(1, queue_capacity)) {
+    writer_running_ = true;
+    writer_thread_ = std::thread(&SwapBackend::writerLoop, this);
+}
+
+SwapBackend::~SwapBackend() {
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        writer_running_ = false;
+    }
+    queue_cv_.notify_all();
+    if (writer_thread_.joinable()) {
+        writer_thread_.join();
+    }
+}
+
+double SwapBackend::transferCostUs(double fixed_latency_us) const {
+    // latency + page_size / bandwidth
+    double transfer_us = (static_cast<double>(page_size_) / (model_.bandwidth_mb_per_s * 1e6)) * 1e6;
+    return fixed_latency_us + transfer_us;
+}
+
+void SwapBackend::swapIn(int page_number) {
+    (void)page_number;
+    reads_.fetch_add(1, std::memory_order_relaxed);
+    simulated_read_ns_.fetch_add(
+        static_cast<uint64_t>(transferCostUs(model_.read_latency_us) * 1000.0),
+        std::memory_order_relaxed);
+}
+
+void SwapBackend::swapOut(int page_number) {
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        if (write_queue_.size() < queue_capacity_) {
+            write_queue_.push_back(page_number);
+            size_t depth = write_queue_.size();
+            size_t prev_max = max_queue_depth_.load(std::memory_order_relaxed);
+            while (depth > prev_max &&
+                   !max_queue_depth_.compare_exchange_weak(prev_max, depth)) {
+            }
+            queue_cv_.notify_one();
+            return;
+        }
+    }
+
+    // Queue full: the device is saturated, so this eviction pays the
+    // write cost synchronously — exactly the stall the queue normally
+    // hides
+    write_stalls_.fetch_add(1, std::memory_order_relaxed);
+    writes_.fetch_add(1, std::memory_order_relaxed);
+    simulated_write_ns_.fetch_add(
+        static_cast<uint64_t>(transferCostUs(model_.write_latency_us) * 1000.0),
+        std::memory_order_relaxed);
+}
+
+void SwapBackend::writerLoop() {
+    // Service the queue at the device's modeled rate: each wake covers
+    // ~1ms of device time, so the number of writes retired per wake is
+    // 1ms / per-write cost (at least one). Queue depth then reflects
+    // how bursty eviction traffic is relative to device speed.
+    const double write_cost_us = transferCostUs(model_.write_latency_us);
+    const size_t writes_per_wake = std::max<size_t>(1, static_cast<size_t>(1000.0 / write_cost_us));
+
+    std::unique_lock<std::mutex> lock(queue_mutex_);
+    while (writer_running_) {
+        queue_cv_.wait_for(lock, std::chrono::milliseconds(1),
+                           [&] { return !write_queue_.empty() || !writer_running_; });
+
+        size_t budget = writes_per_wake;
+        while (budget > 0 && !write_queue_.empty()) {
+            write_queue_.pop_front();
+            budget--;
+            writes_.fetch_add(1, std::memory_order_relaxed);
+            simulated_write_ns_.fetch_add(
+                static_cast<uint64_t>(write_cost_us * 1000.0),
+                std::memory_order_relaxed);
+        }
+    }
+
+    // Retire whatever is left so no write-back is lost on shutdown
+    while (!write_queue_.empty()) {
+        write_queue_.pop_front();
+        writes_.fetch_add(1, std::memory_order_relaxed);
+        simulated_write_ns_.fetch_add(
+            static_cast<uint64_t>(write_cost_us * 1000.0),
+            std::memory_order_relaxed);
+    }
+}
+
+void SwapBackend::drain() {
+    while (true) {
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex_);
+            if (write_queue_.empty()) {
+                return;
+            }
+        }
+        queue_cv_.notify_one();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+SwapMetricsSnapshot SwapBackend::getMetricsSnapshot() const {
+    SwapMetricsSnapshot snapshot;
+    snapshot.reads = reads_.load(std::memory_order_relaxed);
+    snapshot.writes = writes_.load(std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        snapshot.queue_depth = write_queue_.size();
+    }
+    snapshot.max_queue_depth = max_queue_depth_.load(std::memory_order_relaxed);
+    snapshot.write_stalls = write_stalls_.load(std::memory_order_relaxed);
+    snapshot.simulated_read_ms = simulated_read_ns_.load(std::memory_order_relaxed) / 1e6;
+    snapshot.simulated_write_ms = simulated_write_ns_.load(std::memory_order_relaxed) / 1e6;
+    snapshot.simulated_total_ms = snapshot.simulated_read_ms + snapshot.simulated_write_ms;
+    return snapshot;
+}
+
+} // namespace vmm
@@ -0,0 +1,82 @@
+#include "vmm/TLB.h"
+
+namespace vmm {
+
+namespace {
+size_t roundDownPowerOfTwo(size_t value) {
+    size_t power = 1;
+    while (power * 2 <= value) {
+        power *= 2;
+    }
+    return power;
+}
+} // namespace
+
+TLB::TLB(size_t total_entries, size_t ways) {
+    ways_ = ways > 0 ? ways : 1;
+    size_t sets = total_entries / ways_;
+    sets_ = roundDownPowerOfTwo(sets > 0 ? sets : 1);
+    entries_.resize(sets_ * ways_);
+}
+
+bool TLB::lookup(int page_number, int& frame_number) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    TLBEntry* set = &entries_[setIndex(page_number) * ways_];
+    for (size_t w = 0; w < ways_; ++w) {
+        if (set[w].valid && set[w].page == page_number) {
+            set[w].last_used = ++tick_;
+            frame_number = set[w].frame;
+            hits_.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    misses_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+void TLB::insert(int page_number, int frame_number) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    TLBEntry* set = &entries_[setIndex(page_number) * ways_];
+
+    // Reuse an existing or invalid slot first, otherwise evict the
+    // least recently used way in this set
+    TLBEntry* victim = &set[0];
+    for (size_t w = 0; w < ways_; ++w) {
+        if (set[w].valid && set[w].page == page_number) {
+            victim = &set[w];
+            break;
+        }
+        if (!set[w].valid) {
+            victim = &set[w];
+            break;
+        }
+        if (set[w].last_used < victim->last_used) {
+            victim = &set[w];
+        }
+    }
+
+    victim->page = page_number;
+    victim->frame = frame_number;
+    victim->valid = true;
+    victim->last_used = ++tick_;
+}
+
+void TLB::invalidate(int page_number) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    TLBEntry* set = &entries_[setIndex(page_number) * ways_];
+    for (size_t w = 0; w < ways_; ++w) {
+        if (set[w].valid && set[w].page == page_number) {
+            set[w].valid = false;
+            return;
+        }
+    }
+}
+
+void TLB::flush() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& entry : entries_) {
+        entry.valid = false;
+    }
+}
+
+} // namespace vmm
@@ -1,109 +1,308 @@
 #include "vmm/VMM.h"
 #include <algorithm>
+#include <fstream>
 #include <random>
 #include <iostream>
 
 namespace vmm {
 
 VMM::VMM(const VMMConfig& config) : config_(config) {
-    // Initialize page table
-    page_table_ = std::make_unique<PageTable>(config_.page_size, config_.total_pages);
-    
+    access_history_.reset(new std::atomic<int>[HISTORY_CAPACITY]);
+    for (size_t i = 0; i < HISTORY_CAPACITY; ++i) {
+        access_history_[i].store(-1, std::memory_order_relaxed);
+    }
+    initializeState();
+}
+
+VMM::~VMM() {
+    stopPredictorThread();
+    stopAgingThread();
+}
+
+void VMM::initializeState() {
+    // One page table and one lock per simulated address space
+    size_t num_spaces = std::max<size_t>(1, config_.num_address_spaces);
+    page_tables_.clear();
+    space_mutexes_.clear();
+    tlbs_.clear();
+    for (size_t i = 0; i < num_spaces; ++i) {
+        page_tables_.push_back(std::make_unique<PageTable>(
+            config_.page_size, config_.total_pages, true, config_.page_table_levels));
+        space_mutexes_.push_back(std::make_unique<std::mutex>());
+        tlbs_.push_back(config_.tlb_entries > 0
+            ? std::make_unique<TLB>(config_.tlb_entries, config_.tlb_associativity)
+            : nullptr);
+    }
+    fault_patterns_.assign(num_spaces, FaultPattern());
+
     // Initialize replacement manager
     replacement_manager_ = std::make_unique<ReplacementManager>(
         config_.replacement_policy, config_.total_frames);
-    
+
     // Initialize frame management
-    frame_validity_.resize(config_.total_frames, false);
-    frame_to_page_.resize(config_.total_frames, -1);
-    frame_modified_.resize(config_.total_frames, false);
+    frame_table_.reset(config_.total_frames);
+    frame_sharers_.clear();
+    cow_shared_mappings_ = 0;
+
+    // Build the sharded free-frame allocator: frames are split into
+    // contiguous blocks, one free list per shard
+    size_t num_shards = std::max<size_t>(1, std::min(config_.frame_pool_shards, config_.total_frames));
+    frames_per_shard_ = (config_.total_frames + num_shards - 1) / num_shards;
+    frame_shards_.clear();
+    for (size_t s = 0; s < num_shards; ++s) {
+        auto shard = std::make_unique<FrameShard>();
+        size_t begin = s * frames_per_shard_;
+        size_t end = std::min(begin + frames_per_shard_, config_.total_frames);
+        for (size_t f = begin; f < end; ++f) {
+            shard->free_frames.push_back(static_cast<int>(f));
+        }
+        frame_shards_.push_back(std::move(shard));
+    }
+
+    // Group the shards into contiguous NUMA-node segments
+    num_numa_nodes_ = std::max<size_t>(1, std::min(config_.numa_nodes, num_shards));
+    shards_per_node_ = num_shards / num_numa_nodes_;
+    numa_local_allocations_ = 0;
+    numa_remote_allocations_ = 0;
+
+    free_frame_count_ = config_.total_frames;
+
+    // Initialize event ring
+    event_ring_ = std::make_unique<EventRingBuffer>(config_.event_ring_capacity);
+
+    // Initialize the simulated swap device
+    swap_backend_ = std::make_unique<SwapBackend>(
+        config_.swap_device, config_.page_size, config_.swap_write_queue_capacity);
+
+    // Shared-memory channel to the predictor sidecar, if configured.
+    // Tear down the previous channel first: its destructor unlinks the
+    // segment, which would remove a just-recreated one of the same name.
+    predictor_channel_.reset();
+    if (config_.enable_ai_predictions && !config_.ai_predictor_shm.empty()) {
+        predictor_channel_ = std::make_unique<PredictorChannel>(
+            config_.ai_predictor_shm, HISTORY_CAPACITY);
+    }
+
+    // Initialize instrumentation
+    if (config_.instrumentation_sample_interval > 0) {
+        instrumentation_ = std::make_unique<Instrumentation>(
+            config_.total_pages, config_.instrumentation_sample_interval);
+    } else {
+        instrumentation_.reset();
+    }
 }
 
 bool VMM::accessPage(int page_number, bool is_write) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    
+    return accessPage(0, page_number, is_write);
+}
+
+bool VMM::accessPage(int address_space, int page_number, bool is_write) {
+    std::shared_lock<std::shared_mutex> structure_lock(structure_mutex_);
+    if (address_space < 0 || address_space >= static_cast<int>(page_tables_.size())) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(*space_mutexes_[address_space]);
+    return accessPageLocked(address_space, page_number, is_write);
+}
+
+size_t VMM::accessBatch(const std::vector<PageAccess>& accesses) {
+    return accessBatch(0, accesses);
+}
+
+size_t VMM::accessBatch(int address_space, const std::vector<PageAccess>& accesses) {
+    // Process a whole batch under a single lock acquisition. The hit path
+    // only bumps atomic counters and updates access-tracking state, so
+    // amortizing the mutex across the batch removes the per-access
+    // contention that dominates high-rate driver threads.
+    std::shared_lock<std::shared_mutex> structure_lock(structure_mutex_);
+    if (address_space < 0 || address_space >= static_cast<int>(page_tables_.size())) {
+        return 0;
+    }
+    std::lock_guard<std::mutex> lock(*space_mutexes_[address_space]);
+
+    size_t processed = 0;
+    for (const auto& access : accesses) {
+        if (!accessPageLocked(address_space, access.page_number, access.is_write)) {
+            break;
+        }
+        processed++;
+    }
+    return processed;
+}
+
+size_t VMM::cloneAddressSpace(int parent, int child) {
+    std::shared_lock<std::shared_mutex> structure_lock(structure_mutex_);
+    int num_spaces = static_cast<int>(page_tables_.size());
+    if (parent < 0 || parent >= num_spaces || child < 0 || child >= num_spaces ||
+        parent == child) {
+        return 0;
+    }
+
+    // Both space locks in index order (consistent with the space ->
+    // mutex_ lock order used everywhere else)
+    std::lock_guard<std::mutex> first_lock(*space_mutexes_[std::min(parent, child)]);
+    std::lock_guard<std::mutex> second_lock(*space_mutexes_[std::max(parent, child)]);
+    std::lock_guard<std::mutex> frame_lock(mutex_);
+
+    PageTable& src = pageTable(parent);
+    PageTable& dst = pageTable(child);
+
+    size_t shared = 0;
+    for (int page : src.getValidPages()) {
+        if (dst.isPageValid(page)) {
+            continue;  // don't clobber pages the child already owns
+        }
+        int frame = src.getFrameNumber(page);
+        if (frame < 0) {
+            continue;
+        }
+
+        // First sharer seeds the reverse map with the primary mapping
+        auto& sharers = frame_sharers_[frame];
+        if (sharers.empty()) {
+            const FrameEntry& entry = frame_table_.entry(frame);
+            sharers.emplace_back(entry.address_space, entry.page);
+        }
+        sharers.emplace_back(child, page);
+        frame_table_.addRef(frame);
+        cow_shared_mappings_.fetch_add(1, std::memory_order_relaxed);
+
+        src.setPageCOW(page, true);
+        dst.setPageValid(page, true);
+        dst.setFrameNumber(page, frame);
+        dst.setPageCOW(page, true);
+        shared++;
+    }
+
+    emitEvent("COW", "Cloned " + std::to_string(shared) + " pages from space " +
+              std::to_string(parent) + " into space " + std::to_string(child));
+    return shared;
+}
+
+bool VMM::accessPageLocked(int address_space, int page_number, bool is_write) {
     if (!simulation_running_) {
         return false;
     }
-    
+    if (page_number < 0) {
+        // A negative page can never be resident; reject it here so the
+        // fault path doesn't claim a frame for an unmappable entry
+        return false;
+    }
+
+    PageTable& table = pageTable(address_space);
+
     metrics_.total_accesses++;
     updateRecentAccesses(page_number);
-    
-    // Request AI predictions for prefetching
-    if (config_.enable_ai_predictions && recent_accesses_.size() >= 3) {
-        std::vector<int> predictions = requestAIPredictions();
-        if (!predictions.empty()) {
-            // Prefetch predicted pages
-            for (int predicted_page : predictions) {
-                if (predicted_page != page_number && !page_table_->isPageValid(predicted_page)) {
-                    // Check if we have free frames for prefetching
-                    int free_frame = findFreeFrame();
-                    if (free_frame != -1) {
-                        swapIn(predicted_page, free_frame);
-                        emitEvent("AI", "Prefetched page " + std::to_string(predicted_page) + " based on AI prediction");
-                    }
-                }
-            }
+    if (!config_.access_log_file.empty()) {
+        // Same record layout as TRACE_WRITE_BIT/TRACE_PAGE_MASK in
+        // workload/WorkloadGen.h, so the log replays via --trace
+        std::lock_guard<std::mutex> log_lock(log_mutex_);
+        access_log_.push_back(static_cast<uint32_t>(page_number) |
+                              (is_write ? 0x80000000u : 0u));
+    }
+    if (instrumentation_) {
+        instrumentation_->recordAccess(page_number);
+    }
+
+    // Consult the TLB before the page table; a hit skips the table
+    // lookup (and its lock) entirely. Reference bits go stale on TLB
+    // hits, just like hardware-walked tables.
+    TLB* tlb = tlbs_[address_space].get();
+    int frame_number = -1;
+    bool tlb_hit = false;
+    if (tlb != nullptr) {
+        if (tlb->lookup(page_number, frame_number)) {
+            metrics_.tlb_hits++;
+            tlb_hit = true;
+        } else {
+            metrics_.tlb_misses++;
         }
     }
-    
+
     // Check if page is in memory
-    if (page_table_->isPageValid(page_number)) {
-        int frame_number = page_table_->getFrameNumber(page_number);
-        page_table_->recordPageAccess(page_number, metrics_.total_accesses);
-        replacement_manager_->recordFrameAccess(frame_number);
-        
+    if (tlb_hit || table.isPageValid(page_number)) {
+        if (!tlb_hit) {
+            frame_number = table.getFrameNumber(page_number);
+            table.recordPageAccess(page_number, metrics_.total_accesses);
+            if (tlb != nullptr) {
+                tlb->insert(page_number, frame_number);
+            }
+        }
+        {
+            std::lock_guard<std::mutex> repl_lock(replacement_mutex_);
+            frame_table_.recordAccess(frame_number, metrics_.total_accesses);
+            replacement_manager_->recordFrameAccess(frame_number);
+            replacement_manager_->recordPageAccess(page_number);
+        }
+
         // Check if this was a successful AI prediction
-        if (config_.enable_ai_predictions && !recent_predictions_.empty()) {
-            // Check if this page was in our recent predictions
-            auto it = std::find(recent_predictions_.begin(), recent_predictions_.end(), page_number);
-            if (it != recent_predictions_.end()) {
-                metrics_.ai_hits++;
-                emitEvent("AI", "AI HIT: Page " + std::to_string(page_number) + " was correctly predicted!");
-                // Remove this prediction from the list to avoid double counting
-                recent_predictions_.erase(it);
+        if (config_.enable_ai_predictions) {
+            std::lock_guard<std::mutex> ai_lock(ai_mutex_);
+            if (!recent_predictions_.empty()) {
+                // Check if this page was in our recent predictions
+                auto it = std::find(recent_predictions_.begin(), recent_predictions_.end(), page_number);
+                if (it != recent_predictions_.end()) {
+                    metrics_.ai_hits++;
+                    emitEvent("AI", "AI HIT: Page " + std::to_string(page_number) + " was correctly predicted!");
+                    // Remove this prediction from the list to avoid double counting
+                    recent_predictions_.erase(it);
+                }
             }
         }
-        
+
         if (is_write) {
-            page_table_->setPageModified(page_number, true);
-            frame_modified_[frame_number] = true;
+            if (table.isPageCOW(page_number)) {
+                // Write to a shared frame: copy the page to a private
+                // frame first (a real MMU would raise a protection
+                // fault here; the TLB cannot shortcut past this check
+                // because COW pages are looked up by page number)
+                frame_number = handleCOWWrite(address_space, page_number);
+            } else {
+                table.setPageModified(page_number, true);
+                std::lock_guard<std::mutex> frame_lock(mutex_);
+                frame_table_.setDirty(frame_number, true);
+            }
         }
-        
-        emitEvent("ACCESS", "Page " + std::to_string(page_number) + 
-                  (is_write ? " (write)" : " (read)"));
+
+        recordEvent(EventType::ACCESS, page_number, frame_number, is_write);
         return true;
     }
-    
+
     // Page fault occurred
-    handlePageFault(page_number, is_write);
+    handlePageFault(address_space, page_number, is_write);
     return true;
 }
 
 void VMM::startSimulation() {
-    std::lock_guard<std::mutex> lock(mutex_);
     simulation_running_ = true;
+    if (config_.enable_ai_predictions) {
+        startPredictorThread();
+    }
+    if (config_.replacement_policy == ReplacementPolicy::ACTIVE_INACTIVE) {
+        startAgingThread();
+    }
     emitEvent("SIMULATION", "Simulation started");
 }
 
 void VMM::stopSimulation() {
-    std::lock_guard<std::mutex> lock(mutex_);
     simulation_running_ = false;
+    stopPredictorThread();
+    stopAgingThread();
+    swap_backend_->drain();
+    writeAccessLog();
     emitEvent("SIMULATION", "Simulation stopped");
 }
 
 void VMM::setConfig(const VMMConfig& config) {
+    // Exclusive structure lock: waits out every in-flight access (they
+    // hold it shared) and blocks new ones while the per-space tables,
+    // TLBs and mutexes are torn down and rebuilt
+    std::unique_lock<std::shared_mutex> structure_lock(structure_mutex_);
     std::lock_guard<std::mutex> lock(mutex_);
     config_ = config;
-    
+
     // Reinitialize components with new config
-    page_table_ = std::make_unique<PageTable>(config_.page_size, config_.total_pages);
-    replacement_manager_ = std::make_unique<ReplacementManager>(
-        config_.replacement_policy, config_.total_frames);
-    
-    frame_validity_.resize(config_.total_frames, false);
-    frame_to_page_.resize(config_.total_frames, -1);
-    frame_modified_.resize(config_.total_frames, false);
+    initializeState();
 }
 
 size_t VMM::getTotalAccesses() const {
@@ -130,6 +329,14 @@ size_t VMM::getAIHits() const {
     return metrics_.ai_hits.load();
 }
 
+size_t VMM::getTLBHits() const {
+    return metrics_.tlb_hits.load();
+}
+
+size_t VMM::getTLBMisses() const {
+    return metrics_.tlb_misses.load();
+}
+
 double VMM::getPageFaultRate() const {
     size_t total = metrics_.total_accesses.load();
     return total > 0 ? static_cast<double>(metrics_.page_faults.load()) / total : 0.0;
@@ -144,14 +351,51 @@ double VMM::getAIPredictionConfidence() const {
     return ai_prediction_confidence_.load();
 }
 
+VMMMetricsSnapshot VMM::getMetricsSnapshot() const {
+    VMMMetricsSnapshot snapshot;
+    snapshot.total_accesses = metrics_.total_accesses.load();
+    snapshot.page_faults = metrics_.page_faults.load();
+    snapshot.swap_ins = metrics_.swap_ins.load();
+    snapshot.swap_outs = metrics_.swap_outs.load();
+    snapshot.ai_predictions = metrics_.ai_predictions.load();
+    snapshot.ai_hits = metrics_.ai_hits.load();
+    snapshot.tlb_hits = metrics_.tlb_hits.load();
+    snapshot.tlb_misses = metrics_.tlb_misses.load();
+    snapshot.cluster_prefetches = metrics_.cluster_prefetches.load();
+    snapshot.numa_local_allocations = numa_local_allocations_.load(std::memory_order_relaxed);
+    snapshot.numa_remote_allocations = numa_remote_allocations_.load(std::memory_order_relaxed);
+    snapshot.cow_breaks = metrics_.cow_breaks.load();
+    snapshot.cow_shared_mappings = cow_shared_mappings_.load(std::memory_order_relaxed);
+    snapshot.tlb_hit_rate = (snapshot.tlb_hits + snapshot.tlb_misses) > 0
+        ? static_cast<double>(snapshot.tlb_hits) / (snapshot.tlb_hits + snapshot.tlb_misses) : 0.0;
+    snapshot.page_fault_rate = snapshot.total_accesses > 0
+        ? static_cast<double>(snapshot.page_faults) / snapshot.total_accesses : 0.0;
+    snapshot.ai_hit_rate = snapshot.ai_predictions > 0
+        ? static_cast<double>(snapshot.ai_hits) / snapshot.ai_predictions : 0.0;
+    snapshot.ai_prediction_confidence = ai_prediction_confidence_.load();
+    snapshot.free_frames = free_frame_count_.load(std::memory_order_relaxed);
+    snapshot.used_frames = config_.total_frames - snapshot.free_frames;
+    snapshot.dedup_ratio = snapshot.used_frames > 0
+        ? static_cast<double>(snapshot.used_frames + snapshot.cow_shared_mappings)
+              / snapshot.used_frames : 1.0;
+    return snapshot;
+}
+
+SwapMetricsSnapshot VMM::getSwapMetricsSnapshot() const {
+    return swap_backend_->getMetricsSnapshot();
+}
+
 void VMM::resetMetrics() {
-    std::lock_guard<std::mutex> lock(mutex_);
     metrics_.total_accesses = 0;
     metrics_.page_faults = 0;
     metrics_.swap_ins = 0;
     metrics_.swap_outs = 0;
     metrics_.ai_predictions = 0;
     metrics_.ai_hits = 0;
+    metrics_.tlb_hits = 0;
+    metrics_.tlb_misses = 0;
+    metrics_.cluster_prefetches = 0;
+    metrics_.cow_breaks = 0;
 }
 
 void VMM::setEventCallback(std::function<void(const VMMEvent&)> callback) {
@@ -160,21 +404,40 @@ void VMM::setEventCallback(std::function<void(const VMMEvent&)> callback) {
 }
 
 std::vector<int> VMM::getRecentAccesses() const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return recent_accesses_;
+    // Snapshot the tail of the lock-free history ring, oldest first
+    size_t pos = history_pos_.load(std::memory_order_acquire);
+    size_t count = std::min(pos, MAX_RECENT_ACCESSES);
+    std::vector<int> recent;
+    recent.reserve(count);
+    for (size_t i = pos - count; i < pos; ++i) {
+        int page = access_history_[i & (HISTORY_CAPACITY - 1)].load(std::memory_order_relaxed);
+        if (page >= 0) {
+            recent.push_back(page);
+        }
+    }
+    return recent;
 }
 
 void VMM::setAIPredictions(const std::vector<int>& predicted_pages) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    
     metrics_.ai_predictions++;
     emitEvent("AI", "Received " + std::to_string(predicted_pages.size()) + " predictions");
-    
-    // Prefetch predicted pages if they're not already in memory
+
+    // Prefetch predicted pages (into the default address space) if
+    // they're not already in memory
+    std::lock_guard<std::mutex> space_lock(*space_mutexes_[0]);
+    PageTable& table = pageTable(0);
     for (int page : predicted_pages) {
-        if (!page_table_->isPageValid(page)) {
-            int free_frame = findFreeFrame();
+        if (!table.isPageValid(page)) {
+            int free_frame = findFreeFrame(0);
             if (free_frame != -1) {
+                std::lock_guard<std::mutex> frame_lock(mutex_);
+                frame_table_.assign(free_frame, 0, page);
+                table.setPageValid(page, true);
+                table.setFrameNumber(page, free_frame);
+                {
+                    std::lock_guard<std::mutex> repl_lock(replacement_mutex_);
+                    replacement_manager_->recordPagePlacement(free_frame, page);
+                }
                 swapIn(page, free_frame);
                 metrics_.ai_hits++;
                 emitEvent("AI", "Prefetched page " + std::to_string(page));
@@ -183,131 +446,524 @@ void VMM::setAIPredictions(const std::vector<int>& predicted_pages) {
     }
 }
 
+void VMM::setFutureTrace(const std::vector<int>& future_pages) {
+    std::lock_guard<std::mutex> repl_lock(replacement_mutex_);
+    replacement_manager_->setFutureTrace(future_pages);
+}
+
 size_t VMM::getFreeFrameCount() const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return std::count(frame_validity_.begin(), frame_validity_.end(), false);
+    return free_frame_count_.load(std::memory_order_relaxed);
 }
 
 size_t VMM::getUsedFrameCount() const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return std::count(frame_validity_.begin(), frame_validity_.end(), true);
+    return config_.total_frames - free_frame_count_.load(std::memory_order_relaxed);
 }
 
 std::vector<int> VMM::getValidPages() const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return page_table_->getValidPages();
+    std::shared_lock<std::shared_mutex> structure_lock(structure_mutex_);
+    return page_tables_[0]->getValidPages();
 }
 
-int VMM::allocateFrame() {
-    int free_frame = findFreeFrame();
-    if (free_frame != -1) {
-        frame_validity_[free_frame] = true;
-        frame_modified_[free_frame] = false;
-        return free_frame;
+void VMM::deallocateFrame(int frame_number) {
+    if (frame_number >= 0 && frame_number < static_cast<int>(frame_table_.size())) {
+        frame_table_.release(frame_number);
+
+        // Return the frame to its home shard
+        size_t shard = std::min(frame_number / frames_per_shard_,
+                                frame_shards_.size() - 1);
+        std::lock_guard<std::mutex> shard_lock(frame_shards_[shard]->mutex);
+        frame_shards_[shard]->free_frames.push_back(frame_number);
+        free_frame_count_.fetch_add(1, std::memory_order_relaxed);
     }
-    return -1;
 }
 
-void VMM::deallocateFrame(int frame_number) {
-    if (frame_number >= 0 && frame_number < static_cast<int>(frame_validity_.size())) {
-        frame_validity_[frame_number] = false;
-        frame_to_page_[frame_number] = -1;
-        frame_modified_[frame_number] = false;
+int VMM::findFreeFrame(int shard_hint) {
+    // Node-local first: walk the shards of the hinted node, then steal
+    // from the other nodes' segments only when the local one is empty
+    size_t num_shards = frame_shards_.size();
+    size_t node = static_cast<size_t>(shard_hint) % num_numa_nodes_;
+    size_t local_begin = node * shards_per_node_;
+    size_t local_end = (node == num_numa_nodes_ - 1) ? num_shards
+                                                     : local_begin + shards_per_node_;
+
+    auto popFrom = [this](size_t shard_index) {
+        FrameShard& shard = *frame_shards_[shard_index];
+        std::lock_guard<std::mutex> shard_lock(shard.mutex);
+        if (shard.free_frames.empty()) {
+            return -1;
+        }
+        int frame = shard.free_frames.back();
+        shard.free_frames.pop_back();
+        free_frame_count_.fetch_sub(1, std::memory_order_relaxed);
+        return frame;
+    };
+
+    size_t local_count = local_end - local_begin;
+    for (size_t i = 0; i < local_count; ++i) {
+        size_t index = local_begin + (static_cast<size_t>(shard_hint) + i) % local_count;
+        int frame = popFrom(index);
+        if (frame != -1) {
+            numa_local_allocations_.fetch_add(1, std::memory_order_relaxed);
+            return frame;
+        }
     }
-}
 
-int VMM::findFreeFrame() const {
-    for (size_t i = 0; i < frame_validity_.size(); ++i) {
-        if (!frame_validity_[i]) {
-            return static_cast<int>(i);
+    for (size_t i = 0; i < num_shards; ++i) {
+        if (i >= local_begin && i < local_end) {
+            continue;
+        }
+        int frame = popFrom(i);
+        if (frame != -1) {
+            numa_remote_allocations_.fetch_add(1, std::memory_order_relaxed);
+            return frame;
         }
     }
     return -1;
 }
 
-void VMM::handlePageFault(int page_number, bool is_write) {
+void VMM::handlePageFault(int address_space, int page_number, bool is_write) {
     metrics_.page_faults++;
-    emitEvent("FAULT", "Page fault for page " + std::to_string(page_number));
-    
-    int frame_number = allocateFrame();
+    recordEvent(EventType::FAULT, page_number, -1, is_write);
+
+    PageTable& table = pageTable(address_space);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    int frame_number = claimFrame(address_space);
     if (frame_number == -1) {
-        // No free frames, need to evict
-        frame_number = replacement_manager_->selectVictimFrame(frame_validity_, *page_table_);
-        if (frame_number == -1) {
-            emitEvent("ERROR", "No victim frame found");
-            return;
-        }
-        
-        // Evict the victim page
-        int victim_page = frame_to_page_[frame_number];
-        if (victim_page != -1) {
-            page_table_->setPageValid(victim_page, false);
-            if (frame_modified_[frame_number]) {
-                swapOut(victim_page, frame_number);
-            }
-            emitEvent("EVICT", "Evicted page " + std::to_string(victim_page) + 
-                      " from frame " + std::to_string(frame_number));
-        }
+        emitEvent("ERROR", "No victim frame found");
+        return;
     }
-    
+
     // Load the new page
     swapIn(page_number, frame_number);
-    page_table_->setPageValid(page_number, true);
-    page_table_->setFrameNumber(page_number, frame_number);
-    page_table_->recordPageAccess(page_number, metrics_.total_accesses);
-    
+    table.setPageValid(page_number, true);
+    table.setFrameNumber(page_number, frame_number);
+    table.recordPageAccess(page_number, metrics_.total_accesses);
+    if (tlbs_[address_space]) {
+        tlbs_[address_space]->insert(page_number, frame_number);
+    }
+
+    frame_table_.assign(frame_number, address_space, page_number);
     if (is_write) {
-        page_table_->setPageModified(page_number, true);
-        frame_modified_[frame_number] = true;
+        table.setPageModified(page_number, true);
+        frame_table_.setDirty(frame_number, true);
+    }
+
+    {
+        std::lock_guard<std::mutex> repl_lock(replacement_mutex_);
+        frame_table_.recordAccess(frame_number, metrics_.total_accesses);
+        replacement_manager_->recordFrameAccess(frame_number);
+        replacement_manager_->recordPagePlacement(frame_number, page_number);
+        replacement_manager_->recordPageAccess(page_number);
+    }
+
+    // Stride-clustering prefetch: two consecutive faults with the same
+    // stride confirm a pattern, and the rest of the cluster is mapped
+    // in right here — still under the single mutex_ acquisition, with
+    // frames drawn from the batch allocator. Once clustering kicks in,
+    // faults land every cluster_size * stride pages, so a fault stride
+    // that is a multiple of the confirmed unit stride keeps the pattern
+    // alive instead of breaking it.
+    FaultPattern& pattern = fault_patterns_[address_space];
+    int stride = pattern.last_page >= 0 ? page_number - pattern.last_page : 0;
+    bool confirmed = false;
+    if (stride != 0) {
+        if (pattern.unit_stride != 0 &&
+            (stride > 0) == (pattern.unit_stride > 0) &&
+            stride % pattern.unit_stride == 0) {
+            confirmed = true;
+        } else if (stride == pattern.last_stride) {
+            pattern.unit_stride = stride;
+            confirmed = true;
+        } else {
+            pattern.unit_stride = 0;
+        }
+    }
+    pattern.last_stride = stride;
+    pattern.last_page = page_number;
+    if (confirmed && config_.fault_cluster_size > 1) {
+        prefetchCluster(address_space, page_number, pattern.unit_stride);
+    }
+}
+
+// Claims a frame for address_space, evicting a victim when the free
+// lists are empty. Caller holds mutex_.
+int VMM::claimFrame(int address_space) {
+    int frame_number = findFreeFrame(address_space);
+    if (frame_number != -1) {
+        return frame_number;
+    }
+
+    // No free frames, need to evict
+    {
+        std::lock_guard<std::mutex> repl_lock(replacement_mutex_);
+        frame_number = replacement_manager_->selectVictimFrame(frame_table_);
+    }
+    if (frame_number == -1) {
+        return -1;
+    }
+
+    // Evict the victim page (it may belong to another address space;
+    // page tables are internally synchronized so this is safe while
+    // holding only our own space lock). A shared frame takes every
+    // sharer's mapping down with it.
+    const FrameEntry& victim = frame_table_.entry(frame_number);
+    if (victim.valid && victim.page != -1 && victim.address_space != -1) {
+        if (frame_table_.isShared(frame_number)) {
+            unmapSharers(frame_number);
+        } else {
+            pageTable(victim.address_space).setPageValid(victim.page, false);
+            pageTable(victim.address_space).setPageCOW(victim.page, false);
+            if (tlbs_[victim.address_space]) {
+                tlbs_[victim.address_space]->invalidate(victim.page);
+            }
+        }
+        if (victim.dirty) {
+            swapOut(victim.page, frame_number);
+        }
+        recordEvent(EventType::EVICT, victim.page, frame_number);
+    }
+    frame_table_.release(frame_number);
+    return frame_number;
+}
+
+// First write to a COW mapping: copy the page to a private frame and
+// drop our reference on the shared one. Caller holds the space lock.
+// Returns the frame now backing the page.
+int VMM::handleCOWWrite(int address_space, int page_number) {
+    PageTable& table = pageTable(address_space);
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    // Re-check under mutex_: an eviction of the shared frame may have
+    // unmapped us between the lock-free check and here
+    if (!table.isPageValid(page_number) || !table.isPageCOW(page_number)) {
+        return table.isPageValid(page_number) ? table.getFrameNumber(page_number) : -1;
+    }
+
+    int old_frame = table.getFrameNumber(page_number);
+    if (!frame_table_.isShared(old_frame)) {
+        // Every other sharer already copied away; take exclusive
+        // ownership of the frame instead of copying
+        table.setPageCOW(page_number, false);
+        table.setPageModified(page_number, true);
+        frame_table_.setDirty(old_frame, true);
+        return old_frame;
+    }
+
+    // claimFrame may evict — possibly the shared frame itself, in which
+    // case our mapping is gone and the write faults in fresh state
+    int new_frame = claimFrame(address_space);
+    if (new_frame == -1) {
+        return old_frame;
+    }
+    if (!table.isPageValid(page_number)) {
+        deallocateFrame(new_frame);
+        return -1;
+    }
+
+    metrics_.cow_breaks++;
+    removeSharer(old_frame, address_space, page_number);
+
+    table.setFrameNumber(page_number, new_frame);
+    table.setPageCOW(page_number, false);
+    table.setPageModified(page_number, true);
+    if (tlbs_[address_space]) {
+        tlbs_[address_space]->invalidate(page_number);
+        tlbs_[address_space]->insert(page_number, new_frame);
+    }
+
+    frame_table_.assign(new_frame, address_space, page_number);
+    frame_table_.setDirty(new_frame, true);
+    {
+        std::lock_guard<std::mutex> repl_lock(replacement_mutex_);
+        frame_table_.recordAccess(new_frame, metrics_.total_accesses);
+        replacement_manager_->recordFrameAccess(new_frame);
+        replacement_manager_->recordPagePlacement(new_frame, page_number);
+    }
+
+    recordEvent(EventType::COW_BREAK, page_number, new_frame, true);
+    return new_frame;
+}
+
+// Drops one (space, page) mapping from a shared frame. When a single
+// sharer remains it inherits exclusive ownership: its COW bit clears
+// and the reverse-map entry goes away. Caller holds mutex_.
+void VMM::removeSharer(int frame_number, int address_space, int page_number) {
+    int remaining = frame_table_.dropRef(frame_number);
+    cow_shared_mappings_.fetch_sub(1, std::memory_order_relaxed);
+
+    auto it = frame_sharers_.find(frame_number);
+    if (it == frame_sharers_.end()) {
+        return;
+    }
+    auto& sharers = it->second;
+    for (size_t i = 0; i < sharers.size(); ++i) {
+        if (sharers[i].first == address_space && sharers[i].second == page_number) {
+            sharers.erase(sharers.begin() + i);
+            break;
+        }
+    }
+
+    if (remaining == 1 && sharers.size() == 1) {
+        int owner_space = sharers[0].first;
+        int owner_page = sharers[0].second;
+        frame_table_.setOwner(frame_number, owner_space, owner_page);
+        pageTable(owner_space).setPageCOW(owner_page, false);
+        frame_sharers_.erase(it);
+    } else if (!sharers.empty()) {
+        // Keep the FrameEntry's primary mapping pointing at a live sharer
+        frame_table_.setOwner(frame_number, sharers[0].first, sharers[0].second);
+    } else {
+        frame_sharers_.erase(it);
+    }
+}
+
+// Eviction of a shared frame: every sharer's mapping goes down with it.
+// Caller holds mutex_.
+void VMM::unmapSharers(int frame_number) {
+    auto it = frame_sharers_.find(frame_number);
+    if (it == frame_sharers_.end()) {
+        return;
+    }
+    size_t mappings = it->second.size();
+    for (const auto& sharer : it->second) {
+        pageTable(sharer.first).setPageValid(sharer.second, false);
+        pageTable(sharer.first).setPageCOW(sharer.second, false);
+        if (tlbs_[sharer.first]) {
+            tlbs_[sharer.first]->invalidate(sharer.second);
+        }
+    }
+    if (mappings > 1) {
+        cow_shared_mappings_.fetch_sub(mappings - 1, std::memory_order_relaxed);
+    }
+    frame_sharers_.erase(it);
+}
+
+void VMM::prefetchCluster(int address_space, int page_number, int stride) {
+    // Caller holds the space lock and mutex_. Like OS readahead, the
+    // cluster may evict resident pages — on a scan, the pages behind
+    // the fault are exactly the right victims anyway.
+    PageTable& table = pageTable(address_space);
+    for (size_t k = 1; k < config_.fault_cluster_size; ++k) {
+        long next = static_cast<long>(page_number) + static_cast<long>(stride) * static_cast<long>(k);
+        if (next < 0 || next >= static_cast<long>(config_.total_pages)) {
+            break;
+        }
+        int page = static_cast<int>(next);
+        if (table.isPageValid(page)) {
+            continue;
+        }
+        int frame_number = claimFrame(address_space);
+        if (frame_number == -1) {
+            break;
+        }
+        swapIn(page, frame_number);
+        table.setPageValid(page, true);
+        table.setFrameNumber(page, frame_number);
+        frame_table_.assign(frame_number, address_space, page);
+        {
+            std::lock_guard<std::mutex> repl_lock(replacement_mutex_);
+            frame_table_.recordAccess(frame_number, metrics_.total_accesses);
+            replacement_manager_->recordFrameAccess(frame_number);
+            replacement_manager_->recordPagePlacement(frame_number, page);
+        }
+        metrics_.cluster_prefetches++;
     }
-    
-    frame_to_page_[frame_number] = page_number;
-    replacement_manager_->recordFrameAccess(frame_number);
 }
 
 void VMM::swapIn(int page_number, int frame_number) {
     metrics_.swap_ins++;
-    emitEvent("SWAP_IN", "Swapped in page " + std::to_string(page_number) + 
-              " to frame " + std::to_string(frame_number));
+    swap_backend_->swapIn(page_number);
+    recordEvent(EventType::SWAP_IN, page_number, frame_number);
 }
 
 void VMM::swapOut(int page_number, int frame_number) {
     metrics_.swap_outs++;
-    emitEvent("SWAP_OUT", "Swapped out page " + std::to_string(page_number) + 
-              " from frame " + std::to_string(frame_number));
+    swap_backend_->swapOut(page_number);
+    recordEvent(EventType::SWAP_OUT, page_number, frame_number);
 }
 
 void VMM::emitEvent(const std::string& type, const std::string& message, const std::string& data) {
     if (event_callback_) {
-        VMMEvent event(type, message, data);
+        VMMEvent event(type, message, eventTimestamp(), data);
         event_callback_(event);
     }
 }
 
+size_t VMM::eventTimestamp() const {
+    // Logical-clock mode stamps events with the access count instead of
+    // wall time, so two identical runs produce identical event streams
+    if (config_.logical_timestamps) {
+        return metrics_.total_accesses.load(std::memory_order_relaxed);
+    }
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+void VMM::writeAccessLog() {
+    size_t written = 0;
+    {
+        std::lock_guard<std::mutex> log_lock(log_mutex_);
+        if (config_.access_log_file.empty() || access_log_.empty()) {
+            return;
+        }
+        std::ofstream out(config_.access_log_file, std::ios::binary);
+        if (out.is_open()) {
+            out.write(reinterpret_cast<const char*>(access_log_.data()),
+                      access_log_.size() * sizeof(uint32_t));
+            written = access_log_.size();
+        }
+        access_log_.clear();
+    }
+    if (written > 0) {
+        emitEvent("SIMULATION", "Recorded " + std::to_string(written) +
+                  " accesses to " + config_.access_log_file);
+    }
+}
+
+void VMM::recordEvent(EventType type, int page, int frame, bool is_write) {
+    // ACCESS records are sampled 1-in-N so a hot loop does not fill the
+    // ring with noise; structural events (faults, evictions, swaps) are
+    // always recorded.
+    if (type == EventType::ACCESS && config_.access_event_sample_interval > 1) {
+        if (access_event_counter_.fetch_add(1, std::memory_order_relaxed) %
+                config_.access_event_sample_interval != 0) {
+            return;
+        }
+    }
+
+    event_ring_->tryPush(EventRecord(type, page, frame, is_write, eventTimestamp()));
+}
+
+size_t VMM::drainEventRecords(std::vector<EventRecord>& out, size_t max_records) {
+    return event_ring_->drain(out, max_records);
+}
+
+size_t VMM::getDroppedEventCount() const {
+    return event_ring_->getDroppedCount();
+}
+
 void VMM::updateRecentAccesses(int page_number) {
-    recent_accesses_.push_back(page_number);
-    if (recent_accesses_.size() > MAX_RECENT_ACCESSES) {
-        recent_accesses_.erase(recent_accesses_.begin());
+    // Two relaxed atomic ops; the ring is lossy under overwrite, which
+    // is fine for prediction history
+    size_t pos = history_pos_.fetch_add(1, std::memory_order_relaxed);
+    access_history_[pos & (HISTORY_CAPACITY - 1)].store(page_number, std::memory_order_relaxed);
+
+    // Mirror the stream into the sidecar's shared-memory ring: one slot
+    // store plus a release increment, dropped (never blocking) when the
+    // sidecar lags
+    if (predictor_channel_) {
+        predictor_channel_->pushAccess(page_number);
     }
 }
 
-std::vector<int> VMM::requestAIPredictions() {
-    std::cout << "AI Prediction Request - enable_ai_predictions: " << config_.enable_ai_predictions 
-              << ", recent_accesses size: " << recent_accesses_.size() << std::endl;
-    
-    if (!config_.enable_ai_predictions || recent_accesses_.empty()) {
-        return {};
+void VMM::startPredictorThread() {
+    if (predictor_running_) {
+        return;
+    }
+    predictor_running_ = true;
+    predictor_thread_ = std::thread(&VMM::predictorLoop, this);
+}
+
+void VMM::stopPredictorThread() {
+    if (predictor_running_) {
+        predictor_running_ = false;
+        if (predictor_thread_.joinable()) {
+            predictor_thread_.join();
+        }
     }
-    
+}
+
+void VMM::startAgingThread() {
+    if (aging_running_) {
+        return;
+    }
+    aging_running_ = true;
+    aging_thread_ = std::thread(&VMM::agingLoop, this);
+}
+
+void VMM::stopAgingThread() {
+    if (aging_running_) {
+        aging_running_ = false;
+        if (aging_thread_.joinable()) {
+            aging_thread_.join();
+        }
+    }
+}
+
+// Background aging daemon: incrementally migrates frames between the
+// active and inactive lists by consuming the reference bits the access
+// path stamps into the FrameTable. Each tick does at most
+// aging_scan_budget frames of work, so aging never blocks the fault
+// path for more than a short bounded scan. Both locks are needed, in
+// the usual mutex_ -> replacement_mutex_ order: the scan reads frame
+// occupancy (valid bits change under mutex_ via assign/release) as well
+// as the reference bits and list state guarded by replacement_mutex_.
+void VMM::agingLoop() {
+    while (aging_running_) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        if (!simulation_running_) {
+            continue;
+        }
+        std::lock_guard<std::mutex> frame_lock(mutex_);
+        std::lock_guard<std::mutex> repl_lock(replacement_mutex_);
+        replacement_manager_->ageTick(frame_table_, config_.aging_scan_budget);
+    }
+}
+
+void VMM::predictorLoop() {
+    while (predictor_running_) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        if (!simulation_running_ || !config_.enable_ai_predictions) {
+            continue;
+        }
+
+        // Out-of-process predictions first: the sidecar reads the access
+        // ring on its own schedule and parks page numbers in the return
+        // ring, so a poll here is just two index loads
+        if (predictor_channel_ && predictor_channel_->isOpen()) {
+            std::vector<int> predictions;
+            if (predictor_channel_->pollPredictions(predictions, MAX_RECENT_ACCESSES) > 0) {
+                ai_predictions_made_++;
+                metrics_.ai_predictions++;
+                {
+                    std::lock_guard<std::mutex> ai_lock(ai_mutex_);
+                    recent_predictions_.insert(recent_predictions_.end(),
+                                               predictions.begin(), predictions.end());
+                    if (recent_predictions_.size() > 50) {
+                        recent_predictions_.erase(
+                            recent_predictions_.begin(),
+                            recent_predictions_.begin() + (recent_predictions_.size() - 50));
+                    }
+                }
+                applyPredictions(predictions);
+            }
+            continue; // sidecar owns prediction; skip the heuristic
+        }
+
+        std::vector<int> history = getRecentAccesses();
+        if (history.size() < 3) {
+            continue;
+        }
+
+        std::vector<int> predictions = computePredictions(history);
+        if (!predictions.empty()) {
+            applyPredictions(predictions);
+        }
+    }
+}
+
+std::vector<int> VMM::computePredictions(const std::vector<int>& history) {
     std::vector<int> predictions;
-    
+
     try {
         // Simulate AI prediction with realistic patterns
-        if (recent_accesses_.size() >= 3) {
-            int last_page = recent_accesses_.back();
-            int second_last = recent_accesses_[recent_accesses_.size() - 2];
-            int third_last = recent_accesses_[recent_accesses_.size() - 3];
-            
+        if (history.size() >= 3) {
+            int last_page = history.back();
+            int second_last = history[history.size() - 2];
+            int third_last = history[history.size() - 3];
+
             // Pattern 1: Sequential access (high confidence)
             if (last_page == second_last + 1 && second_last == third_last + 1) {
                 predictions.push_back((last_page + 1) % config_.total_pages);
@@ -329,27 +985,29 @@ std::vector<int> VMM::requestAIPredictions() {
                 predictions.push_back((base + (last_page % 10 + 2) % 10) % config_.total_pages);
                 ai_prediction_confidence_ = 0.60;
             }
-            
+
             // Add some random predictions for variety
             if (predictions.size() < 3) {
                 predictions.push_back((last_page + 3) % config_.total_pages);
             }
         }
-        
+
         // Update AI metrics
         if (!predictions.empty()) {
             ai_predictions_made_++;
             metrics_.ai_predictions++;
-            
+
             // Store predictions for hit tracking
-            recent_predictions_.insert(recent_predictions_.end(), predictions.begin(), predictions.end());
-            
-            // Keep only recent predictions (last 50 to avoid memory buildup)
-            if (recent_predictions_.size() > 50) {
-                recent_predictions_.erase(recent_predictions_.begin(), recent_predictions_.begin() + (recent_predictions_.size() - 50));
+            {
+                std::lock_guard<std::mutex> ai_lock(ai_mutex_);
+                recent_predictions_.insert(recent_predictions_.end(), predictions.begin(), predictions.end());
+
+                // Keep only recent predictions (last 50 to avoid memory buildup)
+                if (recent_predictions_.size() > 50) {
+                    recent_predictions_.erase(recent_predictions_.begin(), recent_predictions_.begin() + (recent_predictions_.size() - 50));
+                }
             }
-            
-            std::cout << "AI Predictions made: " << predictions.size() << ", total: " << metrics_.ai_predictions << std::endl;
+
             // Send prediction data in format expected by frontend
             std::string prediction_data = "Predicted {";
             for (size_t i = 0; i < predictions.size(); ++i) {
@@ -357,18 +1015,45 @@ std::vector<int> VMM::requestAIPredictions() {
                 prediction_data += std::to_string(predictions[i]);
             }
             prediction_data += "}";
-            
+
             emitEvent("AI", prediction_data);
-            emitEvent("AI", "Generated " + std::to_string(predictions.size()) + " predictions (confidence: " + 
+            emitEvent("AI", "Generated " + std::to_string(predictions.size()) + " predictions (confidence: " +
                      std::to_string(ai_prediction_confidence_) + ")");
         }
-        
+
     } catch (const std::exception& e) {
         emitEvent("AI", "Prediction failed: " + std::string(e.what()));
         ai_prediction_confidence_ = 0.0;
     }
-    
+
     return predictions;
 }
 
+void VMM::applyPredictions(const std::vector<int>& predictions) {
+    // Opportunistic prefetch into the default address space, between
+    // access batches: take the space lock like any other access stream
+    std::lock_guard<std::mutex> space_lock(*space_mutexes_[0]);
+    PageTable& table = pageTable(0);
+
+    for (int page : predictions) {
+        if (page < 0 || table.isPageValid(page)) {
+            continue;
+        }
+        int free_frame = findFreeFrame(0);
+        if (free_frame == -1) {
+            break; // no free frames: never evict for a guess
+        }
+        std::lock_guard<std::mutex> frame_lock(mutex_);
+        frame_table_.assign(free_frame, 0, page);
+        table.setPageValid(page, true);
+        table.setFrameNumber(page, free_frame);
+        {
+            std::lock_guard<std::mutex> repl_lock(replacement_mutex_);
+            replacement_manager_->recordPagePlacement(free_frame, page);
+        }
+        swapIn(page, free_frame);
+        emitEvent("AI", "Prefetched page " + std::to_string(page) + " based on AI prediction");
+    }
+}
+
 } // namespace vmm
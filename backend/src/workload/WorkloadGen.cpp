@@ -3,19 +3,179 @@
 #include <cmath>
 #include <iostream>
 
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 namespace workload {
 
-WorkloadGenerator::WorkloadGenerator(const WorkloadConfig& config) 
-    : config_(config), rng_(std::random_device{}()), 
+// AliasSampler Implementation (Walker/Vose method)
+void AliasSampler::build(const std::vector<double>& weights) {
+    size_t n = weights.size();
+    prob_.assign(n, 0.0);
+    alias_.assign(n, 0);
+    if (n == 0) {
+        return;
+    }
+
+    double total = 0.0;
+    for (double w : weights) {
+        total += w;
+    }
+    if (total <= 0.0) {
+        // Degenerate input: fall back to uniform
+        prob_.assign(n, 1.0);
+        for (size_t i = 0; i < n; ++i) {
+            alias_[i] = static_cast<int>(i);
+        }
+        return;
+    }
+
+    // Scale weights so the average bucket holds probability 1
+    std::vector<double> scaled(n);
+    for (size_t i = 0; i < n; ++i) {
+        scaled[i] = weights[i] * n / total;
+    }
+
+    std::vector<int> small, large;
+    small.reserve(n);
+    large.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        (scaled[i] < 1.0 ? small : large).push_back(static_cast<int>(i));
+    }
+
+    while (!small.empty() && !large.empty()) {
+        int s = small.back(); small.pop_back();
+        int l = large.back(); large.pop_back();
+        prob_[s] = scaled[s];
+        alias_[s] = l;
+        scaled[l] = (scaled[l] + scaled[s]) - 1.0;
+        (scaled[l] < 1.0 ? small : large).push_back(l);
+    }
+    for (int i : large) {
+        prob_[i] = 1.0;
+        alias_[i] = i;
+    }
+    for (int i : small) {
+        prob_[i] = 1.0;
+        alias_[i] = i;
+    }
+}
+
+void AliasSampler::clear() {
+    prob_.clear();
+    alias_.clear();
+}
+
+int AliasSampler::sample(std::mt19937& rng) const {
+    if (prob_.empty()) {
+        return -1;
+    }
+    std::uniform_int_distribution<size_t> bucket_dist(0, prob_.size() - 1);
+    std::uniform_real_distribution<double> coin_dist(0.0, 1.0);
+    size_t bucket = bucket_dist(rng);
+    return coin_dist(rng) < prob_[bucket] ? static_cast<int>(bucket) : alias_[bucket];
+}
+
+WorkloadGenerator::WorkloadGenerator(const WorkloadConfig& config)
+    : config_(config),
       random_dist_(0, static_cast<int>(config.page_range - 1)),
       prob_dist_(0.0, 1.0) {
+    seedRng();
+    applyPhase(0);
+    buildZipfSampler();
     initializeWorkingSet();
+    openTrace();
+}
+
+WorkloadGenerator::~WorkloadGenerator() {
+    closeTrace();
 }
 
 void WorkloadGenerator::setConfig(const WorkloadConfig& config) {
     config_ = config;
     random_dist_ = std::uniform_int_distribution<int>(0, static_cast<int>(config.page_range - 1));
+    seedRng();
+    applyPhase(0);
+    buildZipfSampler();
     initializeWorkingSet();
+    closeTrace();
+    openTrace();
+}
+
+void WorkloadGenerator::seedRng() {
+    // A nonzero seed makes every run of this config produce the exact
+    // same access stream; 0 keeps the old fresh-entropy behavior
+    if (config_.seed != 0) {
+        rng_.seed(config_.seed);
+    } else {
+        rng_.seed(std::random_device{}());
+    }
+}
+
+// Loads a phase's pattern parameters into the live config fields, so
+// the per-type generators run unmodified; the phase list itself stays
+// untouched in config_.phases.
+void WorkloadGenerator::applyPhase(size_t index) {
+    if (config_.phases.empty() || index >= config_.phases.size()) {
+        return;
+    }
+    phase_index_ = index;
+    phase_position_ = 0;
+    const WorkloadPhase& phase = config_.phases[index];
+    config_.type = phase.type;
+    config_.stride = phase.stride;
+    config_.zipf_alpha = phase.zipf_alpha;
+    config_.locality_factor = phase.locality_factor;
+    buildZipfSampler();
+}
+
+void WorkloadGenerator::advancePhaseIfDue() {
+    if (config_.phases.empty()) {
+        return;
+    }
+    const WorkloadPhase& phase = config_.phases[phase_index_];
+    phase_position_++;
+    if (phase.duration == 0 || phase_position_ < phase.duration) {
+        return;
+    }
+
+    // Probabilistic branch first, then program order; the last phase
+    // runs out the rest of the request budget unless it jumps
+    size_t next = phase_index_;
+    if (phase.jump_probability > 0.0 && phase.jump_target >= 0 &&
+        phase.jump_target < static_cast<int>(config_.phases.size()) &&
+        prob_dist_(rng_) < phase.jump_probability) {
+        next = static_cast<size_t>(phase.jump_target);
+    } else if (phase_index_ + 1 < config_.phases.size()) {
+        next = phase_index_ + 1;
+    } else {
+        phase_position_ = 0; // stay in the final phase
+        return;
+    }
+
+    applyPhase(next);
+    if (phase_callback_) {
+        phase_callback_(next, config_.phases[next]);
+    }
+}
+
+void WorkloadGenerator::buildZipfSampler() {
+    zipf_sampler_.clear();
+    if (config_.type != WorkloadType::ZIPF) {
+        return;
+    }
+    // O(page_range) once, instead of O(page_range) per draw
+    std::vector<double> weights(config_.page_range);
+    for (size_t i = 0; i < config_.page_range; ++i) {
+        weights[i] = calculateZipfProbability(static_cast<int>(i) + 1);
+    }
+    zipf_sampler_.build(weights);
 }
 
 void WorkloadGenerator::start() {
@@ -35,6 +195,10 @@ void WorkloadGenerator::setCompletionCallback(std::function<void()> callback) {
     completion_callback_ = callback;
 }
 
+void WorkloadGenerator::setPhaseCallback(std::function<void(size_t, const WorkloadPhase&)> callback) {
+    phase_callback_ = callback;
+}
+
 void WorkloadGenerator::generateNextAccess() {
     if (!running_) return;
     
@@ -57,14 +221,25 @@ void WorkloadGenerator::generateNextAccess() {
         case WorkloadType::WEBSERVER:
             page = generateWebserverAccess();
             break;
+        case WorkloadType::TRACE:
+            page = generateTraceAccess(is_write);
+            break;
     }
-    
+
     if (page >= 0 && access_callback_) {
         access_callback_(page, is_write);
     }
-    
+
     current_position_++;
-    if (current_position_ >= config_.total_requests) {
+    advancePhaseIfDue();
+    size_t request_limit = config_.total_requests;
+    if (config_.type == WorkloadType::TRACE) {
+        // A trace replay ends when the trace does (or earlier if
+        // total_requests caps it)
+        request_limit = (request_limit == 0) ? trace_count_
+                                             : std::min(request_limit, trace_count_);
+    }
+    if (current_position_ >= request_limit) {
         running_ = false;
         if (completion_callback_) {
             completion_callback_();
@@ -73,11 +248,20 @@ void WorkloadGenerator::generateNextAccess() {
 }
 
 std::vector<int> WorkloadGenerator::generateBatch(size_t batch_size) {
+    std::vector<bool> write_mask;
+    return generateBatch(batch_size, write_mask);
+}
+
+std::vector<int> WorkloadGenerator::generateBatch(size_t batch_size,
+                                                  std::vector<bool>& write_mask) {
     std::vector<int> batch;
     batch.reserve(batch_size);
-    
+    write_mask.clear();
+    write_mask.reserve(batch_size);
+
     for (size_t i = 0; i < batch_size; ++i) {
         int page = -1;
+        bool is_write = false;
         switch (config_.type) {
             case WorkloadType::SEQUENTIAL:
                 page = generateSequentialAccess();
@@ -94,12 +278,21 @@ std::vector<int> WorkloadGenerator::generateBatch(size_t batch_size) {
             case WorkloadType::WEBSERVER:
                 page = generateWebserverAccess();
                 break;
+            case WorkloadType::TRACE:
+                // The record carries the original write bit; keep it so a
+                // replay exercises the same dirty/swap-out traffic as the
+                // run that produced the trace
+                page = generateTraceAccess(is_write);
+                break;
         }
         if (page >= 0) {
             batch.push_back(page);
+            write_mask.push_back(is_write);
         }
+        current_position_++;
+        advancePhaseIfDue();
     }
-    
+
     return batch;
 }
 
@@ -118,23 +311,13 @@ int WorkloadGenerator::generateStridedAccess() {
 }
 
 int WorkloadGenerator::generateZipfAccess() {
-    // Generate rank using Zipf distribution
-    double sum = 0.0;
-    for (int i = 1; i <= static_cast<int>(config_.page_range); ++i) {
-        sum += 1.0 / std::pow(i, config_.zipf_alpha);
+    // O(1) draw from the precomputed alias table; the sampler returns a
+    // 0-based rank which doubles as the page number
+    if (zipf_sampler_.size() != config_.page_range) {
+        buildZipfSampler();
     }
-    
-    double random_value = prob_dist_(rng_) * sum;
-    double cumulative = 0.0;
-    
-    for (int i = 1; i <= static_cast<int>(config_.page_range); ++i) {
-        cumulative += 1.0 / std::pow(i, config_.zipf_alpha);
-        if (cumulative >= random_value) {
-            return i - 1; // Convert to 0-based indexing
-        }
-    }
-    
-    return config_.page_range - 1;
+    int page = zipf_sampler_.sample(rng_);
+    return page >= 0 ? page : static_cast<int>(config_.page_range) - 1;
 }
 
 int WorkloadGenerator::generateWebserverAccess() {
@@ -150,6 +333,91 @@ int WorkloadGenerator::generateWebserverAccess() {
     }
 }
 
+int WorkloadGenerator::generateTraceAccess(bool& is_write) {
+    if (trace_records_ == nullptr || trace_position_ >= trace_count_) {
+        return -1;
+    }
+    uint32_t record = trace_records_[trace_position_++];
+    is_write = (record & TRACE_WRITE_BIT) != 0;
+    return static_cast<int>(record & TRACE_PAGE_MASK);
+}
+
+void WorkloadGenerator::openTrace() {
+    trace_records_ = nullptr;
+    trace_count_ = 0;
+    trace_position_ = 0;
+
+    if (config_.type != WorkloadType::TRACE || config_.trace_file.empty()) {
+        return;
+    }
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(config_.trace_file.c_str(), GENERIC_READ, FILE_SHARE_READ,
+                              nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        std::cerr << "Failed to open trace file: " << config_.trace_file << std::endl;
+        return;
+    }
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+        CloseHandle(file);
+        return;
+    }
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (mapping == nullptr) {
+        std::cerr << "Failed to map trace file: " << config_.trace_file << std::endl;
+        return;
+    }
+    void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+    if (data == nullptr) {
+        return;
+    }
+    trace_mapping_ = data;
+    trace_mapping_size_ = static_cast<size_t>(size.QuadPart);
+#else
+    int fd = open(config_.trace_file.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "Failed to open trace file: " << config_.trace_file << std::endl;
+        return;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        close(fd);
+        return;
+    }
+    void* data = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        std::cerr << "Failed to map trace file: " << config_.trace_file << std::endl;
+        return;
+    }
+    // Sequential replay: tell the kernel to read ahead aggressively
+    madvise(data, st.st_size, MADV_SEQUENTIAL);
+    trace_mapping_ = data;
+    trace_mapping_size_ = static_cast<size_t>(st.st_size);
+#endif
+
+    trace_records_ = static_cast<const uint32_t*>(trace_mapping_);
+    trace_count_ = trace_mapping_size_ / sizeof(uint32_t);
+}
+
+void WorkloadGenerator::closeTrace() {
+    if (trace_mapping_ != nullptr) {
+#ifdef _WIN32
+        UnmapViewOfFile(trace_mapping_);
+#else
+        munmap(trace_mapping_, trace_mapping_size_);
+#endif
+        trace_mapping_ = nullptr;
+        trace_mapping_size_ = 0;
+    }
+    trace_records_ = nullptr;
+    trace_count_ = 0;
+    trace_position_ = 0;
+}
+
 void WorkloadGenerator::initializeWorkingSet() {
     working_set_.clear();
     working_set_.reserve(config_.working_set_size);
@@ -158,6 +426,20 @@ void WorkloadGenerator::initializeWorkingSet() {
     for (size_t i = 0; i < std::min(config_.working_set_size, config_.page_range); ++i) {
         working_set_.push_back(random_dist_(rng_));
     }
+
+    // Skewed slot selection for the webserver workload: reuse the alias
+    // sampler with Zipf weights over working-set slots, so a few entries
+    // stay hot the way a real document set does. Slots keep their weight
+    // when updateWorkingSet replaces their contents.
+    if (!working_set_.empty()) {
+        std::vector<double> weights(working_set_.size());
+        for (size_t i = 0; i < weights.size(); ++i) {
+            weights[i] = calculateZipfProbability(static_cast<int>(i) + 1);
+        }
+        working_set_sampler_.build(weights);
+    } else {
+        working_set_sampler_.clear();
+    }
 }
 
 void WorkloadGenerator::updateWorkingSet(int page) {
@@ -174,9 +456,13 @@ int WorkloadGenerator::selectFromWorkingSet() {
     if (working_set_.empty()) {
         return random_dist_(rng_);
     }
-    
-    std::uniform_int_distribution<size_t> ws_dist(0, working_set_.size() - 1);
-    return working_set_[ws_dist(rng_)];
+
+    int slot = working_set_sampler_.sample(rng_);
+    if (slot < 0 || slot >= static_cast<int>(working_set_.size())) {
+        std::uniform_int_distribution<size_t> ws_dist(0, working_set_.size() - 1);
+        return working_set_[ws_dist(rng_)];
+    }
+    return working_set_[slot];
 }
 
 double WorkloadGenerator::calculateZipfProbability(int rank) const {
@@ -185,10 +471,16 @@ double WorkloadGenerator::calculateZipfProbability(int rank) const {
 
 void WorkloadGenerator::reset() {
     current_position_ = 0;
+    trace_position_ = 0;
+    seedRng();  // re-seeding here makes reset() + run repeatable
+    applyPhase(0);
     initializeWorkingSet();
 }
 
 std::string WorkloadGenerator::getWorkloadDescription() const {
+    if (!config_.phases.empty()) {
+        return "Phased workload (" + std::to_string(config_.phases.size()) + " phases)";
+    }
     switch (config_.type) {
         case WorkloadType::SEQUENTIAL:
             return "Sequential access pattern";
@@ -200,6 +492,9 @@ std::string WorkloadGenerator::getWorkloadDescription() const {
             return "Zipf distribution (alpha=" + std::to_string(config_.zipf_alpha) + ")";
         case WorkloadType::WEBSERVER:
             return "Webserver-like access pattern (locality=" + std::to_string(config_.locality_factor) + ")";
+        case WorkloadType::TRACE:
+            return "Trace replay (" + config_.trace_file + ", " +
+                   std::to_string(trace_count_) + " records)";
         default:
             return "Unknown workload type";
     }
@@ -0,0 +1,101 @@
+"""
+Shared-memory channel client for the C++ VMM simulator.
+
+Maps the segment created by the simulator (see backend
+include/vmm/PredictorChannel.h for the authoritative layout) and
+exchanges fixed-size records through two single-producer/single-consumer
+rings: page accesses flow simulator -> predictor, predicted page
+numbers flow back. No JSON, no sockets, no copies beyond the records
+themselves.
+
+Layout (little-endian):
+    0   u32  magic      0x50434D56 ("VMCP")
+    4   u32  version    1
+    8   u32  ring_capacity (power of two)
+    12  u32  reserved
+    16  u64  access_head      (written by the simulator)
+    24  u64  access_tail      (written by us)
+    32  u64  prediction_head  (written by us)
+    40  u64  prediction_tail  (written by the simulator)
+    48  i32[ring_capacity]  access slots
+    ..  i32[ring_capacity]  prediction slots
+"""
+
+import mmap
+import struct
+import logging
+from typing import List
+
+logger = logging.getLogger(__name__)
+
+MAGIC = 0x50434D56
+VERSION = 1
+HEADER_SIZE = 48
+
+_ACCESS_HEAD = 16
+_ACCESS_TAIL = 24
+_PREDICTION_HEAD = 32
+_PREDICTION_TAIL = 40
+
+
+class ShmChannel:
+    """Predictor-side endpoint of the simulator's shared-memory channel."""
+
+    def __init__(self, name: str = "/vmm_predictor"):
+        path = "/dev/shm/" + name.lstrip("/")
+        self._file = open(path, "r+b")
+        self._map = mmap.mmap(self._file.fileno(), 0)
+
+        magic, version, capacity, _ = struct.unpack_from("<IIII", self._map, 0)
+        if magic != MAGIC:
+            raise ValueError(f"bad channel magic {magic:#x} in {path}")
+        if version != VERSION:
+            raise ValueError(f"unsupported channel version {version}")
+
+        self.capacity = capacity
+        self._access_base = HEADER_SIZE
+        self._prediction_base = HEADER_SIZE + 4 * capacity
+        logger.info("mapped %s: %d slots per ring", path, capacity)
+
+    def close(self) -> None:
+        self._map.close()
+        self._file.close()
+
+    def _read_u64(self, offset: int) -> int:
+        return struct.unpack_from("<Q", self._map, offset)[0]
+
+    def _write_u64(self, offset: int, value: int) -> None:
+        struct.pack_into("<Q", self._map, offset, value)
+
+    def poll_accesses(self, max_records: int = 4096) -> List[int]:
+        """Drain pending page-access records from the simulator."""
+        tail = self._read_u64(_ACCESS_TAIL)
+        head = self._read_u64(_ACCESS_HEAD)
+        pages = []
+        while tail < head and len(pages) < max_records:
+            slot = self._access_base + 4 * (tail & (self.capacity - 1))
+            pages.append(struct.unpack_from("<i", self._map, slot)[0])
+            tail += 1
+        if pages:
+            self._write_u64(_ACCESS_TAIL, tail)
+        return pages
+
+    def push_predictions(self, pages: List[int]) -> int:
+        """Queue predicted page numbers for the simulator to prefetch.
+
+        Returns how many were written; the rest are dropped if the
+        simulator has not consumed earlier predictions yet.
+        """
+        head = self._read_u64(_PREDICTION_HEAD)
+        tail = self._read_u64(_PREDICTION_TAIL)
+        written = 0
+        for page in pages:
+            if head - tail >= self.capacity:
+                break
+            slot = self._prediction_base + 4 * (head & (self.capacity - 1))
+            struct.pack_into("<i", self._map, slot, int(page))
+            head += 1
+            written += 1
+        if written:
+            self._write_u64(_PREDICTION_HEAD, head)
+        return written